@@ -0,0 +1,114 @@
+#pragma once
+
+#include <SrmSolver/std_includes.h>
+
+#include <SrmSolver/run_description.h>
+#include <SrmSolver/shape_solver_types.h>
+#include <SrmSolver/solver_callbacks.h>
+#include <SrmSolver/warm_solver_pool.h>
+
+namespace kae {
+
+// Owns a solver together with host mirrors of its fields. The mirrors keep their addresses for the lifetime of
+// the wrapper, so NumPy views created once stay valid and show the state after the latest integrate call.
+// synchronize() rewrites them while the bindings hold no GIL, so a view read concurrently may be torn.
+// The bindings release the GIL around integration, so every member that touches the solver, the callback or
+// the mirrors takes m_mutex; a second Python thread waits for the running call instead of racing it.
+template <class ShapeSolverTypesT>
+class PySolverWrapper
+{
+public:
+
+  using GpuGridType            = typename ShapeSolverTypesT::GpuGridType;
+  using ShapeType              = typename ShapeSolverTypesT::ShapeType;
+  using GasStateType           = typename ShapeSolverTypesT::GasStateType;
+  using PhysicalPropertiesType = typename ShapeSolverTypesT::PhysicalPropertiesType;
+  using SrmSolverType          = typename ShapeSolverTypesT::SrmSolverType;
+  using ElemType               = typename GpuGridType::ElemType;
+
+  explicit PySolverWrapper(const RunDescription & run)
+    : m_solver{ ShapeType{}, ShapeSolverTypesT::initialGasState, run.reinitializeIterationCount,
+                static_cast<ElemType>(run.courant), run.fluxSweep },
+      m_state(GpuGridType::n),
+      m_phi(GpuGridType::n)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    synchronize();
+  }
+
+  void staticIntegrate(unsigned iterationCount, ETimeDiscretizationOrder timeOrder)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_solver.staticIntegrate(iterationCount, timeOrder, m_callback);
+    synchronize();
+  }
+
+  void dynamicIntegrate(unsigned iterationCount, ElemType deltaT, ETimeDiscretizationOrder timeOrder)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_solver.dynamicIntegrate(iterationCount, deltaT, timeOrder, m_callback);
+    synchronize();
+  }
+
+  void laggedDynamicIntegrate(unsigned iterationCount, ElemType deltaT, ETimeDiscretizationOrder timeOrder)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_solver.laggedDynamicIntegrate(iterationCount, deltaT, timeOrder, m_callback);
+    synchronize();
+  }
+
+  void quasiStationaryDynamicIntegrate(unsigned iterationCount, ElemType deltaT, ETimeDiscretizationOrder timeOrder)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_solver.quasiStationaryDynamicIntegrate(iterationCount, deltaT, timeOrder, m_callback);
+    synchronize();
+  }
+
+  static bool matches(const RunDescription & run)
+  {
+    return WarmSolverPool<ShapeSolverTypesT>::matches(run);
+  }
+
+  static ElemType getDefaultDeltaT()
+  {
+    return GpuGridType::hx / 2 / BurningRate<PhysicalPropertiesType>::get(static_cast<ElemType>(1));
+  }
+
+  // Holding the returned lock keeps synchronize() from rewriting the mirrors, e.g. while they are copied.
+  std::unique_lock<std::mutex> lockHostMirrors() const { return std::unique_lock<std::mutex>{ m_mutex }; }
+  GasStateType * stateData() { return m_state.data(); }
+  ElemType * phiData() { return m_phi.data(); }
+
+  std::vector<IntegralData<ElemType>> integrals() const
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_callback.values();
+  }
+
+  SolverStats stats() const
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_solver.stats();
+  }
+
+private:
+
+  // Callers hold m_mutex.
+  void synchronize()
+  {
+    thrust::copy(std::begin(m_solver.currState().values()), std::end(m_solver.currState().values()),
+                 std::begin(m_state));
+    thrust::copy(std::begin(m_solver.currPhi().values()), std::end(m_solver.currPhi().values()),
+                 std::begin(m_phi));
+  }
+
+private:
+
+  SrmSolverType                      m_solver;
+  CollectIntegralsCallback<ElemType> m_callback;
+  thrust::host_vector<GasStateType>  m_state;
+  thrust::host_vector<ElemType>      m_phi;
+  mutable std::mutex                 m_mutex;
+};
+
+} // namespace kae
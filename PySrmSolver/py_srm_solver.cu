@@ -0,0 +1,196 @@
+
+#pragma warning(push, 0)
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#pragma warning(pop)
+
+#include <sstream>
+
+#include "py_solver_wrapper.h"
+
+namespace py = pybind11;
+
+namespace {
+
+kae::ETimeDiscretizationOrder toTimeOrder(unsigned timeOrder)
+{
+  switch (timeOrder)
+  {
+  case 1U:
+    return kae::ETimeDiscretizationOrder::eOne;
+  case 2U:
+    return kae::ETimeDiscretizationOrder::eTwo;
+  case 3U:
+    return kae::ETimeDiscretizationOrder::eThree;
+  default:
+    throw std::invalid_argument("Time order must be 1, 2 or 3");
+  }
+}
+
+template <class ShapeSolverTypesT>
+void bindSolver(py::module & module, const char * name)
+{
+  using WrapperType  = kae::PySolverWrapper<ShapeSolverTypesT>;
+  using GpuGridType  = typename WrapperType::GpuGridType;
+  using GasStateType = typename WrapperType::GasStateType;
+  using ElemType     = typename WrapperType::ElemType;
+
+  const auto integrateMethod = [](auto method)
+  {
+    return [method](WrapperType & wrapper, unsigned iterationCount, std::optional<ElemType> deltaT, unsigned timeOrder)
+    {
+      (wrapper.*method)(iterationCount, deltaT.value_or(WrapperType::getDefaultDeltaT()), toTimeOrder(timeOrder));
+    };
+  };
+
+  py::class_<WrapperType>(module, name)
+    .def(py::init([](unsigned reinitializeIterationCount, double courant)
+         {
+           kae::RunDescription run;
+           run.reinitializeIterationCount = reinitializeIterationCount;
+           run.courant                    = courant;
+           return std::make_unique<WrapperType>(run);
+         }),
+         py::arg("reinitialize") = 100U, py::arg("courant") = 0.8)
+    .def_property_readonly_static("nx", [](py::object) { return GpuGridType::nx; })
+    .def_property_readonly_static("ny", [](py::object) { return GpuGridType::ny; })
+    .def_property_readonly_static("hx", [](py::object) { return GpuGridType::hx; })
+    .def_property_readonly_static("hy", [](py::object) { return GpuGridType::hy; })
+    .def_property_readonly_static("default_delta_t", [](py::object) { return WrapperType::getDefaultDeltaT(); })
+    .def("step",
+         [](WrapperType & wrapper, unsigned timeOrder) { wrapper.staticIntegrate(1U, toTimeOrder(timeOrder)); },
+         py::arg("time_order") = 2U, py::call_guard<py::gil_scoped_release>())
+    .def("static_integrate",
+         [](WrapperType & wrapper, unsigned iterationCount, unsigned timeOrder)
+         {
+           wrapper.staticIntegrate(iterationCount, toTimeOrder(timeOrder));
+         },
+         py::arg("iterations"), py::arg("time_order") = 2U, py::call_guard<py::gil_scoped_release>())
+    .def("dynamic_integrate", integrateMethod(&WrapperType::dynamicIntegrate),
+         py::arg("iterations"), py::arg("delta_t") = py::none(), py::arg("time_order") = 2U,
+         py::call_guard<py::gil_scoped_release>())
+    .def("lagged_dynamic_integrate", integrateMethod(&WrapperType::laggedDynamicIntegrate),
+         py::arg("iterations"), py::arg("delta_t") = py::none(), py::arg("time_order") = 2U,
+         py::call_guard<py::gil_scoped_release>())
+    .def("quasi_stationary_integrate", integrateMethod(&WrapperType::quasiStationaryDynamicIntegrate),
+         py::arg("iterations"), py::arg("delta_t") = py::none(), py::arg("time_order") = 2U,
+         py::call_guard<py::gil_scoped_release>())
+    .def("curr_state", [](py::object self, bool copy)
+    {
+      // (ny, nx, 4) array of rho, ux, uy, p. A view keeps the solver object alive while the array exists.
+      auto & wrapper = self.cast<WrapperType &>();
+      const std::vector<py::ssize_t> shape{ GpuGridType::ny, GpuGridType::nx, 4U };
+      const std::vector<py::ssize_t> strides{ GpuGridType::nx * sizeof(GasStateType), sizeof(GasStateType),
+                                              sizeof(ElemType) };
+      const auto pData = reinterpret_cast<ElemType *>(wrapper.stateData());
+      if (copy)
+      {
+        const auto lock = wrapper.lockHostMirrors();
+        return py::array_t<ElemType>(shape, strides, pData);
+      }
+
+      return py::array_t<ElemType>(shape, strides, pData, self);
+    },
+    "Gas state as a (ny, nx, 4) array of rho, ux, uy, p.\n\n"
+    "By default the array is a view of a host mirror that every integrate call rewrites after it releases the "
+    "GIL, so a view read from another thread while the solver runs may mix two time steps. Pass copy=True for a "
+    "snapshot; it waits for a running integrate call to finish.",
+    py::arg("copy") = false)
+    .def("curr_phi", [](py::object self, bool copy)
+    {
+      auto & wrapper = self.cast<WrapperType &>();
+      const std::vector<py::ssize_t> shape{ GpuGridType::ny, GpuGridType::nx };
+      const std::vector<py::ssize_t> strides{ GpuGridType::nx * sizeof(ElemType), sizeof(ElemType) };
+      if (copy)
+      {
+        const auto lock = wrapper.lockHostMirrors();
+        return py::array_t<ElemType>(shape, strides, wrapper.phiData());
+      }
+
+      return py::array_t<ElemType>(shape, strides, wrapper.phiData(), self);
+    },
+    "Level set as a (ny, nx) array.\n\n"
+    "Aliases a host mirror the same way curr_state does: a view may be torn while another thread integrates, "
+    "copy=True returns a snapshot.",
+    py::arg("copy") = false)
+    .def("integrals", [](const WrapperType & wrapper)
+    {
+      // Columns follow writeIntegralData: t, P_av, P_max, S, Thrust, specThrust, velocity.
+      const auto values = wrapper.integrals();
+      py::array_t<ElemType> result({ static_cast<py::ssize_t>(values.size()), py::ssize_t{ 7 } });
+      auto view = result.template mutable_unchecked<2>();
+      for (std::size_t idx{ 0U }; idx < values.size(); ++idx)
+      {
+        const auto & elem = values[idx];
+        view(idx, 0U) = std::get<0U>(elem);
+        view(idx, 1U) = std::get<1U>(elem);
+        view(idx, 2U) = std::get<2U>(elem);
+        view(idx, 3U) = std::get<3U>(elem);
+        view(idx, 4U) = std::get<4U>(elem);
+        view(idx, 5U) = std::get<5U>(elem);
+        view(idx, 6U) = std::get<6U>(elem);
+      }
+
+      return result;
+    })
+    .def("stats", [](const WrapperType & wrapper)
+    {
+      const auto stats = wrapper.stats();
+      return py::dict(py::arg("mass_flow_solve_count")     = stats.massFlowSolveCount,
+                      py::arg("mass_flow_iteration_count") = stats.massFlowIterationCount);
+    });
+}
+
+template <class... ShapeSolverTypesT>
+py::object makeSolver(const kae::RunDescription & run)
+{
+  py::object solver = py::none();
+  const auto tryMake = [&run, &solver](auto shapeSolverTypes)
+  {
+    using WrapperType = kae::PySolverWrapper<decltype(shapeSolverTypes)>;
+    if (solver.is_none() && WrapperType::matches(run))
+    {
+      solver = py::cast(std::make_unique<WrapperType>(run));
+    }
+  };
+  (tryMake(ShapeSolverTypesT{}), ...);
+
+  if (solver.is_none())
+  {
+    throw std::invalid_argument("Shape and precision are not built into this module");
+  }
+
+  return solver;
+}
+
+} // namespace
+
+PYBIND11_MODULE(pysrmsolver, module)
+{
+  using NozzleLessTypes         = kae::ShapeSolverTypes<kae::EShapeType::eNozzleLessShape,    float>;
+  using WithUmbrellaTypes       = kae::ShapeSolverTypes<kae::EShapeType::eWithUmbrellaShape,  float>;
+  using FlushMountedNozzleTypes = kae::ShapeSolverTypes<kae::EShapeType::eFlushMountedNozzle, float>;
+  using DualThrustTypes         = kae::ShapeSolverTypes<kae::EShapeType::eDualThrustShape,    float>;
+
+  bindSolver<NozzleLessTypes>(module, "NozzleLessSolver");
+  bindSolver<WithUmbrellaTypes>(module, "WithUmbrellaSolver");
+  bindSolver<FlushMountedNozzleTypes>(module, "FlushMountedNozzleSolver");
+  bindSolver<DualThrustTypes>(module, "DualThrustSolver");
+
+  // Keyword arguments use the keys of the daemon's run files, e.g. make_solver(shape="dualThrust", courant=0.6).
+  module.def("make_solver", [](py::kwargs kwargs)
+  {
+    std::ostringstream description;
+    for (const auto & item : kwargs)
+    {
+      const auto value = py::isinstance<py::bool_>(item.second) ?
+        std::string{ item.second.cast<bool>() ? "true" : "false" } : py::str(item.second).cast<std::string>();
+      description << py::str(item.first).cast<std::string>() << " = " << value << '\n';
+    }
+
+    std::istringstream stream{ description.str() };
+    const auto run = kae::parseRunDescription(stream);
+    return makeSolver<NozzleLessTypes, WithUmbrellaTypes, FlushMountedNozzleTypes, DualThrustTypes>(run);
+  });
+}
@@ -0,0 +1,55 @@
+"""Smoke test for the pysrmsolver module.
+
+Run it with the folder holding pysrmsolver.pyd on PYTHONPATH:
+
+    python smoke_test.py
+"""
+
+import threading
+import unittest
+
+import numpy as np
+
+import pysrmsolver
+
+
+class SmokeTest(unittest.TestCase):
+
+    def test_construct_and_step(self):
+        solver = pysrmsolver.NozzleLessSolver(reinitialize=0)
+        ny, nx = pysrmsolver.NozzleLessSolver.ny, pysrmsolver.NozzleLessSolver.nx
+
+        state = solver.curr_state()
+        phi = solver.curr_phi()
+        self.assertEqual(state.shape, (ny, nx, 4))
+        self.assertEqual(phi.shape, (ny, nx))
+        self.assertTrue(np.isfinite(state).all())
+        self.assertTrue((phi < 0).any())
+
+        snapshot = solver.curr_state(copy=True)
+        solver.step()
+
+        # The view follows the solver, the snapshot keeps the state it was taken from.
+        self.assertFalse(np.array_equal(state, snapshot))
+        self.assertTrue(np.array_equal(state, solver.curr_state(copy=True)))
+        self.assertTrue(np.isfinite(state).all())
+
+    def test_reads_during_integration(self):
+        solver = pysrmsolver.NozzleLessSolver(reinitialize=0)
+        worker = threading.Thread(target=solver.quasi_stationary_integrate, args=(20,))
+        worker.start()
+        while worker.is_alive():
+            self.assertEqual(solver.integrals().shape[1], 7)
+            self.assertIn("mass_flow_solve_count", solver.stats())
+            self.assertTrue(np.isfinite(solver.curr_state(copy=True)).all())
+        worker.join()
+
+    def test_make_solver(self):
+        solver = pysrmsolver.make_solver(shape="nozzleLess", reinitialize=0)
+        self.assertIsInstance(solver, pysrmsolver.NozzleLessSolver)
+        with self.assertRaises(ValueError):
+            pysrmsolver.make_solver(shape="nozzleLess", precision="double")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include <functional>
+
+#include "cuda_float_types.h"
+#include "empty_callback.h"
+#include "gpu_matrix.h"
+#include "integral_data.h"
+
+namespace kae {
+
+struct AnalysisQuantity
+{
+  constexpr static std::uint32_t maxDerivatives{ 1U << 0U };
+  constexpr static std::uint32_t burningSurface{ 1U << 1U };
+  constexpr static std::uint32_t integrals{ 1U << 2U };
+  constexpr static std::uint32_t mach{ 1U << 3U };
+  constexpr static std::uint32_t temperature{ 1U << 4U };
+
+  static bool is(std::uint32_t quantities, std::uint32_t quantity)
+  {
+    return (quantities & quantity) != 0U;
+  }
+};
+
+// Read-only view handed to plugins. Quantities nobody subscribed to for this iteration are left empty.
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+struct AnalysisFrame
+{
+  unsigned                               iteration;
+  ElemT                                  t;
+  const GpuMatrix<GpuGridT, GasStateT> & gasValues;
+  const GpuMatrix<GpuGridT, ElemT> &     currPhi;
+  std::optional<CudaFloat4T<ElemT>>      maxDerivatives;
+  std::optional<ElemT>                   sBurn;
+  std::optional<IntegralData<ElemT>>     integrals;
+  const GpuMatrix<GpuGridT, ElemT> *     pMach{ nullptr };
+  const GpuMatrix<GpuGridT, ElemT> *     pTemperature{ nullptr };
+};
+
+// Passed to the integrators in place of a callback. The solver asks which quantities are due at every outer
+// iteration, computes only those and dispatches a single frame to the plugins whose cadence matches.
+template <class GpuGridT, class GasStateT>
+class AnalysisPipeline
+{
+public:
+
+  using FrameType  = AnalysisFrame<GpuGridT, GasStateT>;
+  using PluginType = std::function<void(const FrameType &)>;
+
+  void subscribe(std::uint32_t quantities, unsigned cadence, PluginType plugin)
+  {
+    m_subscriptions.push_back(Subscription{ quantities, std::max(cadence, 1U), std::move(plugin) });
+  }
+
+  // Plugins that declare what they read are subscribed to exactly those quantities.
+  template <class PluginT>
+  auto subscribe(unsigned cadence, PluginT plugin) -> decltype(plugin.quantities(), void())
+  {
+    const auto quantities = plugin.quantities();
+    subscribe(quantities, cadence, PluginType{ std::move(plugin) });
+  }
+
+  bool isDue(unsigned iteration) const
+  {
+    return std::any_of(std::begin(m_subscriptions), std::end(m_subscriptions),
+                       [iteration](const auto & subscription) { return iteration % subscription.cadence == 0U; });
+  }
+
+  std::uint32_t getRequiredQuantities(unsigned iteration) const
+  {
+    std::uint32_t quantities{ 0U };
+    for (const auto & subscription : m_subscriptions)
+    {
+      if (iteration % subscription.cadence == 0U)
+      {
+        quantities |= subscription.quantities;
+      }
+    }
+
+    return quantities;
+  }
+
+  void operator()(const FrameType & frame)
+  {
+    for (const auto & subscription : m_subscriptions)
+    {
+      if (frame.iteration % subscription.cadence == 0U)
+      {
+        subscription.plugin(frame);
+      }
+    }
+  }
+
+private:
+
+  struct Subscription
+  {
+    std::uint32_t quantities;
+    unsigned      cadence;
+    PluginType    plugin;
+  };
+
+  std::vector<Subscription> m_subscriptions;
+};
+
+namespace detail {
+
+template <class CallbackT, class = void>
+struct IsAnalysisPipeline : std::false_type {};
+
+template <class CallbackT>
+struct IsAnalysisPipeline<CallbackT, std::void_t<decltype(std::declval<const CallbackT &>().getRequiredQuantities(0U))>>
+  : std::true_type {};
+
+template <class CallbackT>
+constexpr bool IsAnalysisPipelineV = IsAnalysisPipeline<std::decay_t<CallbackT>>::value;
+
+// Inner gas-dynamic iterations of the dynamic integrators aren't analysis frames, a pipeline only sees the outer loop.
+template <class CallbackT>
+decltype(auto) getInnerCallback(CallbackT & callback)
+{
+  if constexpr (IsAnalysisPipelineV<CallbackT>)
+  {
+    return EmptyCallback{};
+  }
+  else
+  {
+    return (callback);
+  }
+}
+
+} // namespace detail
+
+} // namespace kae
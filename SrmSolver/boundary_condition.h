@@ -4,4 +4,6 @@ namespace kae {
 
 enum class EBoundaryCondition { eWall, ePressureOutlet, eMassFlowInlet, eMirror };
 
+constexpr unsigned boundaryConditionCount{ 4U };
+
 } // namespace kae
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "burn_back_table.h"
+#include "integral_data.h"
+#include "physical_properties.h"
+
+namespace kae {
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT = typename ShapeT::ElemType>
+class BurnBackBallisticsSolver
+{
+public:
+
+  using ElemType = ElemT;
+
+  explicit BurnBackBallisticsSolver(BurnBackTable<ElemType> table, ElemType courant = static_cast<ElemType>(0.2));
+
+  std::vector<IntegralData<ElemType>> integrate(ElemType maxTime) const;
+
+  ElemType getEquilibriumPressure(ElemType web) const;
+
+private:
+
+  struct State
+  {
+    ElemType p;
+    ElemType web;
+  };
+
+  State getDerivatives(const State & state) const;
+  ElemType getDeltaT(const State & state) const;
+  ElemType interpolate(const std::vector<ElemType> & values, ElemType web) const;
+  IntegralData<ElemType> getIntegralData(ElemType t, const State & state) const;
+
+private:
+
+  constexpr static ElemType rt = (PhysicalPropertiesT::kappa - 1) / PhysicalPropertiesT::kappa * PhysicalPropertiesT::H0;
+
+  BurnBackTable<ElemType> m_table;
+  ElemType                m_courant;
+};
+
+} // namespace kae
+
+#include "burn_back_ballistics_solver_def.h"
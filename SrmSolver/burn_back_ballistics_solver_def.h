@@ -0,0 +1,123 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::BurnBackBallisticsSolver(BurnBackTable<ElemType> table,
+                                                                                      ElemType                courant)
+  : m_table(std::move(table)), m_courant{ courant }
+{
+  if (m_table.webs.empty() ||
+      (m_table.burningSurfaces.size() != m_table.webs.size()) ||
+      (m_table.chamberVolumes.size() != m_table.webs.size()))
+  {
+    throw std::invalid_argument("Burn-back table is empty or inconsistent");
+  }
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::interpolate(const std::vector<ElemType> & values,
+                                                                               ElemType web) const -> ElemType
+{
+  const auto & webs = m_table.webs;
+  if (web <= webs.front())
+  {
+    return values.front();
+  }
+
+  const auto upper = std::upper_bound(std::begin(webs), std::end(webs), web);
+  if (upper == std::end(webs))
+  {
+    return values.back();
+  }
+
+  const auto idx    = static_cast<std::size_t>(upper - std::begin(webs));
+  const auto weight = (web - webs[idx - 1U]) / (webs[idx] - webs[idx - 1U]);
+  return (1 - weight) * values[idx - 1U] + weight * values[idx];
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::getDerivatives(const State & state) const -> State
+{
+  const bool isBurning = (state.web < m_table.webs.back());
+  const auto sBurn     = isBurning ? interpolate(m_table.burningSurfaces, state.web) : static_cast<ElemType>(0);
+  const auto volume    = interpolate(m_table.chamberVolumes, state.web);
+
+  const auto burningRate = isBurning ? BurningRate<PhysicalPropertiesT>::get(state.p) : static_cast<ElemType>(0);
+  const auto massIncome  = PhysicalPropertiesT::rhoP * sBurn * burningRate;
+  const auto massOutcome = PhysicalPropertiesT::gammaComplex * ShapeT::getFCritical() * state.p / std::sqrt(rt);
+  return State{ rt / volume * (massIncome - massOutcome), burningRate };
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::getDeltaT(const State & state) const -> ElemType
+{
+  const auto volume         = interpolate(m_table.chamberVolumes, state.web);
+  const auto relaxationTime = volume / (PhysicalPropertiesT::gammaComplex * ShapeT::getFCritical() * std::sqrt(rt));
+  const auto burningRate    = BurningRate<PhysicalPropertiesT>::get(state.p);
+  const auto webStep        = (m_table.webs.size() > 1U) ? (m_table.webs[1U] - m_table.webs[0U]) : relaxationTime;
+  return m_courant * std::min(relaxationTime, webStep / burningRate);
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::getIntegralData(ElemType t, const State & state) const
+  -> IntegralData<ElemType>
+{
+  constexpr auto kappa = PhysicalPropertiesT::kappa;
+  const auto sBurn        = (state.web < m_table.webs.back()) ? interpolate(m_table.burningSurfaces, state.web) :
+                                                                 static_cast<ElemType>(0);
+  const auto massFlowRate = PhysicalPropertiesT::gammaComplex * ShapeT::getFCritical() * state.p / std::sqrt(rt);
+  const auto velocity     = std::sqrt(2 * kappa / (kappa + 1) * rt);
+  const auto throatP      = state.p * std::pow(2 / (kappa + 1), kappa / (kappa - 1));
+  const auto thrust       = massFlowRate * velocity + throatP * ShapeT::getFCritical();
+  return IntegralData<ElemType>{ t, state.p, state.p, sBurn, thrust, thrust / massFlowRate, velocity };
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::getEquilibriumPressure(ElemType web) const
+  -> ElemType
+{
+  const auto sBurn = interpolate(m_table.burningSurfaces, web);
+  return std::pow(-sBurn * PhysicalPropertiesT::mt * std::sqrt(rt) /
+                  PhysicalPropertiesT::gammaComplex / ShapeT::getFCritical(), 1 / (1 - PhysicalPropertiesT::nu));
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+auto BurnBackBallisticsSolver<ShapeT, PhysicalPropertiesT, ElemT>::integrate(ElemType maxTime) const
+  -> std::vector<IntegralData<ElemType>>
+{
+  const auto advance = [this](const State & first, const State & prev, ElemType dt, ElemType prevWeight)
+  {
+    const auto derivatives = getDerivatives(prev);
+    const State next{ std::max(prev.p + dt * derivatives.p, static_cast<ElemType>(0)),
+                      prev.web + dt * derivatives.web };
+    return State{ (1 - prevWeight) * first.p + prevWeight * next.p,
+                  (1 - prevWeight) * first.web + prevWeight * next.web };
+  };
+
+  std::vector<IntegralData<ElemType>> values;
+  State state{ PhysicalPropertiesT::P0, m_table.webs.front() };
+  auto t{ static_cast<ElemType>(0) };
+  values.push_back(getIntegralData(t, state));
+  while (t < maxTime)
+  {
+    const auto dt     = std::min(getDeltaT(state), maxTime - t);
+    const auto first  = advance(state, state, dt, static_cast<ElemType>(1.0));
+    const auto second = advance(state, first, dt, static_cast<ElemType>(0.25));
+    state             = advance(state, second, dt, static_cast<ElemType>(2.0 / 3.0));
+    t += dt;
+    values.push_back(getIntegralData(t, state));
+
+    const bool isBurnedOut = (state.web >= m_table.webs.back());
+    if (isBurnedOut && (state.p <= PhysicalPropertiesT::P0))
+    {
+      break;
+    }
+  }
+
+  return values;
+}
+
+} // namespace kae
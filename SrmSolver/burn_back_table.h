@@ -0,0 +1,16 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+template <class ElemT>
+struct BurnBackTable
+{
+  std::vector<ElemT>              webs;
+  std::vector<ElemT>              burningSurfaces;
+  std::vector<ElemT>              chamberVolumes;
+  std::vector<std::vector<ElemT>> portAreas;
+};
+
+} // namespace kae
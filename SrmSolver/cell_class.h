@@ -0,0 +1,48 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "boundary_condition.h"
+
+namespace kae {
+
+struct CellClass
+{
+  constexpr static std::uint8_t fluid{ 1U << 0U };
+  constexpr static std::uint8_t flux{ 1U << 1U };
+  constexpr static std::uint8_t stencil{ 1U << 2U };
+  constexpr static std::uint8_t ghost{ 1U << 3U };
+  constexpr static std::uint8_t outsideChamber{ 1U << 4U };
+  constexpr static unsigned boundaryConditionShift{ 6U };
+
+  HOST_DEVICE static bool is(std::uint8_t cellClass, std::uint8_t flag)
+  {
+    return (cellClass & flag) != 0U;
+  }
+
+  HOST_DEVICE static bool isSolid(std::uint8_t cellClass)
+  {
+    return (cellClass & (fluid | ghost)) == 0U;
+  }
+
+  HOST_DEVICE static EBoundaryCondition getBoundaryCondition(std::uint8_t cellClass)
+  {
+    return static_cast<EBoundaryCondition>(cellClass >> boundaryConditionShift);
+  }
+
+  template <class GpuGridT, class ElemT>
+  HOST_DEVICE static std::uint8_t get(ElemT level)
+  {
+    return static_cast<std::uint8_t>((level < 0 ? fluid : 0U) |
+                                     (level <= GpuGridT::hx + static_cast<ElemT>(1e-6) ? flux : 0U) |
+                                     (level < 4 * GpuGridT::hx ? stencil : 0U));
+  }
+
+  HOST_DEVICE static std::uint8_t getGhost(EBoundaryCondition boundaryCondition)
+  {
+    return static_cast<std::uint8_t>(ghost | (static_cast<unsigned>(boundaryCondition) << boundaryConditionShift));
+  }
+};
+
+} // namespace kae
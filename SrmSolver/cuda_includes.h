@@ -4,15 +4,20 @@
 #include <cuda_runtime_api.h>
 #include <device_launch_parameters.h>
 
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
 #include <thrust/logical.h>
 #include <thrust/device_ptr.h>
 #include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
 #include <thrust/extrema.h>
 #include <thrust/host_vector.h>
+#include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/transform_iterator.h>
 #include <thrust/reduce.h>
 #include <thrust/remove.h>
 #include <thrust/sequence.h>
+#include <thrust/sort.h>
 #pragma warning(pop)
 
 #ifdef __CUDACC__
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 namespace kae {
 
 namespace detail {
@@ -10,6 +12,9 @@ struct EmptyCallback
   void operator()(T&& ...) {}
 };
 
+template <class CallbackT>
+constexpr bool IsEmptyCallbackV = std::is_same<std::decay_t<CallbackT>, EmptyCallback>::value;
+
 } // namespace detail
 
 } // namespace kae
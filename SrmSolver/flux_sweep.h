@@ -0,0 +1,7 @@
+#pragma once
+
+namespace kae {
+
+enum class EFluxSweep { eFused, eDimensionallySplit };
+
+} // namespace kae
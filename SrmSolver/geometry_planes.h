@@ -0,0 +1,81 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "gpu_matrix.h"
+
+namespace kae {
+
+struct GeometryMask
+{
+  constexpr static std::uint8_t chamber{ 1U << 0U };
+};
+
+namespace detail {
+
+template <class GpuGridT, class ShapeT>
+struct RadiusInitializer
+{
+  HOST_DEVICE typename GpuGridT::ElemType operator()(unsigned i, unsigned j) const
+  {
+    return ShapeT::getRadius(i, j);
+  }
+};
+
+template <class GpuGridT, class ShapeT>
+struct RadiusReciprocalInitializer
+{
+  HOST_DEVICE typename GpuGridT::ElemType operator()(unsigned i, unsigned j) const
+  {
+    return 1 / ShapeT::getRadius(i, j);
+  }
+};
+
+template <class GpuGridT, class ShapeT>
+struct GeometryMaskInitializer
+{
+  HOST_DEVICE std::uint8_t operator()(unsigned i, unsigned j) const
+  {
+    const bool isChamber = ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy);
+    return isChamber ? GeometryMask::chamber : std::uint8_t{ 0U };
+  }
+};
+
+template <class GpuGridT, class ShapeT>
+struct SchemeMaskInitializer
+{
+  HOST_DEVICE std::uint8_t operator()(unsigned i, unsigned j) const
+  {
+    return ShapeT::shouldApplyScheme(i, j) ? 1U : 0U;
+  }
+};
+
+} // namespace detail
+
+template <class GpuGridT, class ShapeT>
+class GeometryPlanes
+{
+public:
+
+  using ElemType = typename GpuGridT::ElemType;
+
+  GeometryPlanes()
+    : m_radii        { detail::RadiusInitializer<GpuGridT, ShapeT>{}           },
+      m_rReciprocals { detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} },
+      m_masks        { detail::GeometryMaskInitializer<GpuGridT, ShapeT>{}     }
+  {
+  }
+
+  const GpuMatrix<GpuGridT, ElemType>     & radii()        const { return m_radii; }
+  const GpuMatrix<GpuGridT, ElemType>     & rReciprocals() const { return m_rReciprocals; }
+  const GpuMatrix<GpuGridT, std::uint8_t> & masks()        const { return m_masks; }
+
+private:
+
+  GpuMatrix<GpuGridT, ElemType>     m_radii;
+  GpuMatrix<GpuGridT, ElemType>     m_rReciprocals;
+  GpuMatrix<GpuGridT, std::uint8_t> m_masks;
+};
+
+} // namespace kae
@@ -4,6 +4,7 @@
 
 #include "boundary_condition.h"
 #include "gas_state.h"
+#include "power_law.h"
 
 #pragma warning( disable : 4068 )
 
@@ -11,25 +12,33 @@ namespace kae {
 
 namespace detail {
 
-template <class PhysicalPropertiesT, class GasStateT>
+template <class PhysicalPropertiesT, class GasStateT, class ElemT = typename GasStateT::ElemType>
 HOST_DEVICE GasStateT getFirstOrderMassFlowExtrapolatedGhostValue(const GasStateT & gasState,
-                                                                  const GasStateT& closestGasState)
+                                                                  const GasStateT & closestGasState,
+                                                                  ElemT &           p1,
+                                                                  unsigned &        iterationCount)
 {
-  using ElemType = typename GasStateT::ElemType;
+  using ElemType = ElemT;
   const auto c = SonicSpeed::get(closestGasState);
 
   constexpr auto kappa    = GasStateT::kappa;
   constexpr auto nu       = PhysicalPropertiesT::nu;
+  using PowerLawT         = PowerLaw<typename PhysicalPropertiesT::NuType>;
   const auto coefficient1 = gasState.ux + 1 / closestGasState.rho / c * gasState.p;
   const auto coefficient2 = -1 / closestGasState.rho / c;
   const auto coefficient3 = kappa / (kappa - 1) / PhysicalPropertiesT::mt;
 
-  ElemType p1 = 10 * gasState.p;
+  if (!(p1 > 0))
+  {
+    p1 = 10 * gasState.p;
+  }
 
+  iterationCount = 0U;
 #pragma unroll
   for (unsigned i{ 0u }; i < 10u; ++i)
   {
-    const auto power = std::pow(p1, -nu);
+    ++iterationCount;
+    const auto power = PowerLawT::getReciprocal(p1);
     const auto fOfP = static_cast<ElemType>(0.5) * coefficient2 * coefficient2 * p1 * p1 +
                       coefficient2 * coefficient3 * p1 * p1 * power +
                       coefficient1 * coefficient2 * p1 + coefficient1 * coefficient3 * p1 * power +
@@ -48,7 +57,16 @@ HOST_DEVICE GasStateT getFirstOrderMassFlowExtrapolatedGhostValue(const GasState
   }
 
   const auto un = coefficient1 + coefficient2 * p1;
-  return GasStateT{ PhysicalPropertiesT::mt * std::pow(p1, nu) / un, un, static_cast<ElemType>(0.0), p1 };
+  return GasStateT{ PhysicalPropertiesT::mt * PowerLawT::get(p1) / un, un, static_cast<ElemType>(0.0), p1 };
+}
+
+template <class PhysicalPropertiesT, class GasStateT>
+HOST_DEVICE GasStateT getFirstOrderMassFlowExtrapolatedGhostValue(const GasStateT & gasState,
+                                                                  const GasStateT & closestGasState)
+{
+  typename GasStateT::ElemType p1{ 0 };
+  unsigned iterationCount{ 0U };
+  return getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesT>(gasState, closestGasState, p1, iterationCount);
 }
 
 template <class PhysicalPropertiesT, class GasStateT>
@@ -110,23 +110,42 @@ HOST_DEVICE auto getPolynomial(const CudaFloat2T<ElemT> surfacePoint,
   return choleskySolve(A, b);
 }
 
-template <class GpuGridT, class GasStateT, class ElemT = typename GpuGridT::ElemType,
-          class InputMatrixT,
-          unsigned order = InputMatrixT::rows,
-          unsigned degreesOfFreedom = order * (order + 1U) / 2>
-HOST_DEVICE auto getWenoPolynomial(const CudaFloat2T<ElemT> surfacePoint,
-                                   const CudaFloat2T<ElemT> normal,
-                                   const GasStateT*         pGasValues,
-                                   const InputMatrixT&      indexMatrix)
+template <class GpuGridT, class InputMatrixT, class ElemT = typename GpuGridT::ElemType,
+          unsigned order            = InputMatrixT::rows,
+          unsigned degreesOfFreedom = order * (order + 1U) / 2,
+          class ReturnT             = kae::Matrix<ElemT, degreesOfFreedom, order * order>>
+HOST_DEVICE ReturnT getPseudoInverse(const CudaFloat2T<ElemT> surfacePoint,
+                                     const CudaFloat2T<ElemT> normal,
+                                     const InputMatrixT&      indexMatrix)
 {
   static_assert(InputMatrixT::rows == InputMatrixT::cols, "");
 
-  const auto subMatrix1 = Submatrix<InputMatrixT, 1U, 1U>{ indexMatrix };
-  const auto subMatrix2 = Submatrix<InputMatrixT, 2U, 2U>{ indexMatrix };
-  const auto p0 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, subMatrix1);
-  const auto p1 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, subMatrix2);
-  //const auto p2 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, indexMatrix);
+  const auto lhsMatrix = getCoordinatesMatrix<GpuGridT>(surfacePoint, normal, indexMatrix);
+  const auto lhsMatrixTr = transpose(lhsMatrix);
+  const kae::Matrix<ElemT, degreesOfFreedom, degreesOfFreedom> A = lhsMatrixTr * lhsMatrix;
+  return choleskySolve(A, lhsMatrixTr);
+}
+
+template <class GpuGridT, class GasStateT, class PseudoInverseT, class ElemT = typename GpuGridT::ElemType,
+          class InputMatrixT>
+HOST_DEVICE auto getCachedPolynomial(const PseudoInverseT&    pseudoInverse,
+                                     const CudaFloat2T<ElemT> normal,
+                                     const GasStateT*         pGasValues,
+                                     const InputMatrixT&      indexMatrix)
+{
+  static_assert(InputMatrixT::rows == InputMatrixT::cols, "");
+  static_assert(PseudoInverseT::cols == InputMatrixT::rows * InputMatrixT::cols, "");
+
+  const auto rhsMatrix = getRightHandSideMatrix<GpuGridT>(normal, pGasValues, indexMatrix);
+  return kae::Matrix<ElemT, PseudoInverseT::rows, 4U>{ pseudoInverse * rhsMatrix };
+}
 
+namespace impl {
+
+template <class GpuGridT, unsigned degreesOfFreedom, class Polynomial0T, class Polynomial1T,
+          class ElemT = typename GpuGridT::ElemType>
+HOST_DEVICE auto combineWenoPolynomials(const Polynomial0T & p0, const Polynomial1T & p1)
+{
   const auto betta0 = getPolynomialWeight<GpuGridT>(p0);
   const auto betta1 = getPolynomialWeight<GpuGridT>(p1);
   //const auto betta2 = getPolynomialWeight<GpuGridT>(p2);
@@ -138,8 +157,8 @@ HOST_DEVICE auto getWenoPolynomial(const CudaFloat2T<ElemT> surfacePoint,
     for (unsigned j{}; j < 4U; ++j)
     {
       constexpr auto zero = static_cast<ElemT>(0);
-      const auto coefficient0 = (i < decltype(p0)::rows) ? p0(i, j) : zero;
-      const auto coefficient1 = (i < decltype(p1)::rows) ? p1(i, j) : zero;
+      const auto coefficient0 = (i < Polynomial0T::rows) ? p0(i, j) : zero;
+      const auto coefficient1 = (i < Polynomial1T::rows) ? p1(i, j) : zero;
       //const auto coefficient2 = p2(i, j);
 
       wenoPolynomial(i, j) = coefficient0 * wenoCoefficients(j, 0U) +
@@ -150,6 +169,48 @@ HOST_DEVICE auto getWenoPolynomial(const CudaFloat2T<ElemT> surfacePoint,
   return wenoPolynomial;
 }
 
+} // namespace impl
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GpuGridT::ElemType,
+          class InputMatrixT,
+          unsigned order = InputMatrixT::rows,
+          unsigned degreesOfFreedom = order * (order + 1U) / 2>
+HOST_DEVICE auto getWenoPolynomial(const CudaFloat2T<ElemT> surfacePoint,
+                                   const CudaFloat2T<ElemT> normal,
+                                   const GasStateT*         pGasValues,
+                                   const InputMatrixT&      indexMatrix)
+{
+  static_assert(InputMatrixT::rows == InputMatrixT::cols, "");
+
+  const auto subMatrix1 = Submatrix<InputMatrixT, 1U, 1U>{ indexMatrix };
+  const auto subMatrix2 = Submatrix<InputMatrixT, 2U, 2U>{ indexMatrix };
+  const auto p0 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, subMatrix1);
+  const auto p1 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, subMatrix2);
+  //const auto p2 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, indexMatrix);
+
+  return impl::combineWenoPolynomials<GpuGridT, degreesOfFreedom>(p0, p1);
+}
+
+template <class GpuGridT, class GasStateT, class PseudoInverseT, class ElemT = typename GpuGridT::ElemType,
+          class InputMatrixT,
+          unsigned order = InputMatrixT::rows,
+          unsigned degreesOfFreedom = order * (order + 1U) / 2>
+HOST_DEVICE auto getCachedWenoPolynomial(const CudaFloat2T<ElemT> surfacePoint,
+                                         const CudaFloat2T<ElemT> normal,
+                                         const PseudoInverseT&    pseudoInverse,
+                                         const GasStateT*         pGasValues,
+                                         const InputMatrixT&      indexMatrix)
+{
+  static_assert(InputMatrixT::rows == InputMatrixT::cols, "");
+
+  const auto subMatrix1 = Submatrix<InputMatrixT, 1U, 1U>{ indexMatrix };
+  const auto subMatrix2 = Submatrix<InputMatrixT, 2U, 2U>{ indexMatrix };
+  const auto p0 = getPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, subMatrix1);
+  const auto p1 = getCachedPolynomial<GpuGridT>(pseudoInverse, normal, pGasValues, subMatrix2);
+
+  return impl::combineWenoPolynomials<GpuGridT, degreesOfFreedom>(p0, p1);
+}
+
 } // namespace detail
 
 } // namespace kae
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "cuda_float_types.h"
+#include "math_utilities.h"
+
+namespace kae {
+
+namespace detail {
+
+struct ArrivalTimeCell
+{
+  constexpr static std::uint8_t excluded{ 0U };
+  constexpr static std::uint8_t seed{ 1U };
+  constexpr static std::uint8_t unknown{ 2U };
+};
+
+template <class GpuGridT, class ElemT = typename GpuGridT::ElemType>
+HOST_DEVICE constexpr ElemT getFarArrivalTime()
+{
+  return 10 * (GpuGridT::lx + GpuGridT::ly);
+}
+
+template <class GpuGridT, class ElemT>
+HOST_DEVICE CudaFloat2T<ElemT> getCentralNormal(const ElemT * pValues, unsigned i, unsigned j)
+{
+  if ((i == 0U) || (j == 0U) || (i + 1U >= GpuGridT::nx) || (j + 1U >= GpuGridT::ny))
+  {
+    return { 0, 0 };
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  const ElemT nx = pValues[globalIdx + 1U] - pValues[globalIdx - 1U];
+  const ElemT ny = pValues[globalIdx + GpuGridT::nx] - pValues[globalIdx - GpuGridT::nx];
+  const ElemT length = std::hypot(nx, ny);
+  return (length > 0) ? CudaFloat2T<ElemT>{ nx / length, ny / length } : CudaFloat2T<ElemT>{ 0, 0 };
+}
+
+template <class GpuGridT, class ShapeT, class ElemT>
+__global__ void initializeArrivalTimes(const ElemT *  pInitialPhi,
+                                       ElemT *        pArrivalTimes,
+                                       std::uint8_t * pArrivalCells)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  const ElemT    level     = pInitialPhi[globalIdx];
+  const ElemT    x         = i * GpuGridT::hx;
+  const ElemT    y         = j * GpuGridT::hy;
+  if ((level <= 0) || !ShapeT::isPointOnGrain(x, y))
+  {
+    pArrivalTimes[globalIdx] = (level <= 0) ? level : getFarArrivalTime<GpuGridT>();
+    pArrivalCells[globalIdx] = ArrivalTimeCell::excluded;
+    return;
+  }
+
+  const auto normal = getCentralNormal<GpuGridT>(pInitialPhi, i, j);
+  const bool isSeed = (level <= GpuGridT::hx) && ShapeT::isPointOnGrain(x - level * normal.x, y - level * normal.y);
+  pArrivalTimes[globalIdx] = isSeed ? level : getFarArrivalTime<GpuGridT>();
+  pArrivalCells[globalIdx] = isSeed ? ArrivalTimeCell::seed : ArrivalTimeCell::unknown;
+}
+
+template <class GpuGridT, class ElemT>
+__device__ ElemT getArrivalNeighbor(const ElemT * pArrivalTimes, const std::uint8_t * pArrivalCells, unsigned idx)
+{
+  return (pArrivalCells[idx] == ArrivalTimeCell::excluded) ? getFarArrivalTime<GpuGridT>() : pArrivalTimes[idx];
+}
+
+template <class GpuGridT, class ElemT>
+__global__ void updateArrivalTimes(ElemT *              pArrivalTimes,
+                                   const std::uint8_t * pArrivalCells,
+                                   unsigned *           pChanged)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i == 0U) || (j == 0U) || (i + 1U >= GpuGridT::nx) || (j + 1U >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  if (pArrivalCells[globalIdx] != ArrivalTimeCell::unknown)
+  {
+    return;
+  }
+
+  constexpr ElemT far = getFarArrivalTime<GpuGridT>();
+  constexpr ElemT h   = GpuGridT::hx;
+  const ElemT a = thrust::min(getArrivalNeighbor<GpuGridT>(pArrivalTimes, pArrivalCells, globalIdx - 1U),
+                              getArrivalNeighbor<GpuGridT>(pArrivalTimes, pArrivalCells, globalIdx + 1U));
+  const ElemT b = thrust::min(getArrivalNeighbor<GpuGridT>(pArrivalTimes, pArrivalCells, globalIdx - GpuGridT::nx),
+                              getArrivalNeighbor<GpuGridT>(pArrivalTimes, pArrivalCells, globalIdx + GpuGridT::nx));
+  if (thrust::min(a, b) >= far)
+  {
+    return;
+  }
+
+  const ElemT candidate = (std::fabs(a - b) >= h) ?
+    thrust::min(a, b) + h : (a + b + std::sqrt(2 * h * h - sqr(a - b))) / 2;
+  if (candidate < pArrivalTimes[globalIdx] - static_cast<ElemT>(1e-4) * h)
+  {
+    pArrivalTimes[globalIdx] = candidate;
+    *pChanged = 1U;
+  }
+}
+
+template <class GpuGridT, class ElemT>
+__global__ void calculateArrivalNormals(const ElemT *        pArrivalTimes,
+                                        CudaFloat2T<ElemT> * pNormals)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  pNormals[j * GpuGridT::nx + i] = getCentralNormal<GpuGridT>(pArrivalTimes, i, j);
+}
+
+template <class GpuGridT, class ShapeT, class ElemT>
+__global__ void calculatePortAreas(const ElemT * pArrivalTimes, ElemT web, ElemT * pPortAreas)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  if (i >= GpuGridT::nx)
+  {
+    return;
+  }
+
+  ElemT portArea{ 0 };
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    const bool isGas = (pArrivalTimes[j * GpuGridT::nx + i] - web < 0);
+    if (isGas && ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy))
+    {
+      portArea += 2 * static_cast<ElemT>(M_PI) * ShapeT::getRadius(i, j) * GpuGridT::hy;
+    }
+  }
+  pPortAreas[i] = portArea;
+}
+
+// Returns false if the sweeps were still lowering arrival times when maxSweepCount was reached.
+template <class GpuGridT, class ShapeT, class ElemT>
+bool solveArrivalTimesWrapper(thrust::device_ptr<const ElemT>        pInitialPhi,
+                              thrust::device_ptr<ElemT>              pArrivalTimes,
+                              thrust::device_ptr<std::uint8_t>       pArrivalCells,
+                              thrust::device_ptr<CudaFloat2T<ElemT>> pNormals,
+                              unsigned &                             sweepCount)
+{
+  initializeArrivalTimes<GpuGridT, ShapeT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pInitialPhi.get(), pArrivalTimes.get(), pArrivalCells.get());
+
+  constexpr unsigned sweepsPerCheck{ 32U };
+  constexpr unsigned maxSweepCount{ 8U * (GpuGridT::nx + GpuGridT::ny) };
+  thrust::device_vector<unsigned> changed(1U, 1U);
+  bool isChanged{ true };
+  sweepCount = 0U;
+  while (isChanged && (sweepCount < maxSweepCount))
+  {
+    changed[0U] = 0U;
+    for (unsigned sweep{ 0U }; sweep < sweepsPerCheck; ++sweep)
+    {
+      updateArrivalTimes<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+        (pArrivalTimes.get(), pArrivalCells.get(), changed.data().get());
+    }
+    sweepCount += sweepsPerCheck;
+    isChanged = (changed[0U] != 0U);
+  }
+
+  calculateArrivalNormals<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pArrivalTimes.get(), pNormals.get());
+  cudaDeviceSynchronize();
+
+  return !isChanged;
+}
+
+template <class GpuGridT, class ShapeT, class ElemT>
+void calculatePortAreasWrapper(thrust::device_ptr<const ElemT> pArrivalTimes,
+                               ElemT                           web,
+                               thrust::device_ptr<ElemT>       pPortAreas)
+{
+  constexpr unsigned blockSize = 64U;
+  constexpr unsigned gridSize  = (GpuGridT::nx + blockSize - 1U) / blockSize;
+  calculatePortAreas<GpuGridT, ShapeT><<<gridSize, blockSize>>>(pArrivalTimes.get(), web, pPortAreas.get());
+}
+
+} // namespace detail
+
+} // namespace kae
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "burn_back_table.h"
+#include "cuda_float_types.h"
+#include "gpu_matrix.h"
+
+namespace kae {
+
+template <class GpuGridT, class ShapeT>
+class GpuBurnBackSolver
+{
+public:
+
+  using ElemType = typename GpuGridT::ElemType;
+
+  // Throws std::runtime_error if the arrival-time sweeps haven't converged within their budget.
+  explicit GpuBurnBackSolver(ShapeT shape = ShapeT{});
+
+  BurnBackTable<ElemType> getTable(ElemType webStep = GpuGridT::hx) const;
+  ElemType getMaxWeb() const;
+
+  const GpuMatrix<GpuGridT, ElemType> & arrivalTimes() const { return m_arrivalTimes; }
+  unsigned sweepCount() const { return m_sweepCount; }
+
+private:
+
+  GpuMatrix<GpuGridT, ElemType>              m_initialPhi;
+  GpuMatrix<GpuGridT, ElemType>              m_arrivalTimes;
+  GpuMatrix<GpuGridT, std::uint8_t>          m_arrivalCells;
+  GpuMatrix<GpuGridT, CudaFloat2T<ElemType>> m_normals;
+  unsigned                                   m_sweepCount{ 0U };
+};
+
+} // namespace kae
+
+#include "gpu_burn_back_solver_def.h"
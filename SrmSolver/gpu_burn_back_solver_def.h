@@ -0,0 +1,78 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "gpu_arrival_time_kernel.h"
+#include "solver_reduction_functions.h"
+
+namespace kae {
+
+template <class GpuGridT, class ShapeT>
+GpuBurnBackSolver<GpuGridT, ShapeT>::GpuBurnBackSolver(ShapeT shape)
+  : m_initialPhi(shape), m_arrivalTimes{ static_cast<ElemType>(0) }, m_arrivalCells{ std::uint8_t{ 0U } },
+    m_normals{ CudaFloat2T<ElemType>{ 0, 0 } }
+{
+  const bool isConverged = detail::solveArrivalTimesWrapper<GpuGridT, ShapeT>(
+    getConstDevicePtr(m_initialPhi),
+    getDevicePtr(m_arrivalTimes),
+    getDevicePtr(m_arrivalCells),
+    getDevicePtr(m_normals),
+    m_sweepCount);
+  if (!isConverged)
+  {
+    throw std::runtime_error("Arrival times did not converge after " + std::to_string(m_sweepCount) + " sweeps");
+  }
+}
+
+template <class GpuGridT, class ShapeT>
+auto GpuBurnBackSolver<GpuGridT, ShapeT>::getMaxWeb() const -> ElemType
+{
+  const auto zipFirst = thrust::make_zip_iterator(
+    thrust::make_tuple(std::begin(m_arrivalTimes.values()), std::begin(m_arrivalCells.values())));
+  const auto zipLast = thrust::make_zip_iterator(
+    thrust::make_tuple(std::end(m_arrivalTimes.values()), std::end(m_arrivalCells.values())));
+
+  const auto toWeb = [] __device__ (const thrust::tuple<ElemType, std::uint8_t> & tuple)
+  {
+    const auto arrivalTime = thrust::get<0U>(tuple);
+    const bool isReached   = (thrust::get<1U>(tuple) != detail::ArrivalTimeCell::excluded) &&
+                             (arrivalTime < detail::getFarArrivalTime<GpuGridT>());
+    return isReached ? arrivalTime : static_cast<ElemType>(0);
+  };
+
+  return thrust::transform_reduce(zipFirst, zipLast, toWeb, static_cast<ElemType>(0), thrust::maximum<ElemType>{});
+}
+
+template <class GpuGridT, class ShapeT>
+auto GpuBurnBackSolver<GpuGridT, ShapeT>::getTable(ElemType webStep) const -> BurnBackTable<ElemType>
+{
+  const auto maxWeb   = getMaxWeb();
+  const auto webCount = static_cast<unsigned>(std::ceil(maxWeb / webStep)) + 1U;
+
+  BurnBackTable<ElemType> table;
+  table.webs.reserve(webCount);
+  table.burningSurfaces.reserve(webCount);
+  table.chamberVolumes.reserve(webCount);
+  table.portAreas.reserve(webCount);
+
+  thrust::device_vector<ElemType> phi(GpuGridT::n);
+  thrust::device_vector<ElemType> portAreas(GpuGridT::nx);
+  for (unsigned idx{ 0U }; idx < webCount; ++idx)
+  {
+    const auto web = std::min(idx * webStep, maxWeb);
+    thrust::transform(std::begin(m_arrivalTimes.values()), std::end(m_arrivalTimes.values()), std::begin(phi),
+                      [web] __device__ (ElemType arrivalTime) { return arrivalTime - web; });
+    detail::calculatePortAreasWrapper<GpuGridT, ShapeT>(getConstDevicePtr(m_arrivalTimes), web, portAreas.data());
+
+    table.webs.push_back(web);
+    table.burningSurfaces.push_back(detail::getBurningSurface<GpuGridT, ShapeT>(phi, m_normals.values()));
+    table.chamberVolumes.push_back(detail::getChamberVolume<GpuGridT, ShapeT>(phi));
+    table.portAreas.emplace_back(GpuGridT::nx);
+    thrust::copy(std::begin(portAreas), std::end(portAreas), std::begin(table.portAreas.back()));
+  }
+
+  return table;
+}
+
+} // namespace kae
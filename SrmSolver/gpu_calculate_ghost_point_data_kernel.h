@@ -3,38 +3,36 @@
 #include "cuda_includes.h"
 
 #include "boundary_condition.h"
+#include "cell_class.h"
 #include "cuda_float_types.h"
+#include "geometry_planes.h"
 #include "get_closest_index.h"
 #include "get_coordinates_matrix.h"
 #include "get_extrapolated_ghost_value.h"
+#include "get_polynomial.h"
+#include "gpu_partition_ghost_points_kernel.h"
+#include "gpu_gas_dynamic_kernel.h"
 #include "level_set_derivatives.h"
 #include "math_utilities.h"
 #include "matrix.h"
 #include "matrix_operations.h"
+#include "submatrix.h"
 
 namespace kae {
 
 namespace detail {
 
-template <class GpuGridT, class ShapeT, unsigned order, class ElemT>
-__global__ void calculateGhostPointData(const ElemT *                         pCurrPhi,
-                                        thrust::pair<unsigned, unsigned> *    pClosestIndices,
-                                        EBoundaryCondition *                  pBoundaryConditions,
-                                        CudaFloat2T<ElemT> *                  pNormals,
-                                        CudaFloat2T<ElemT> *                  pSurfacePoints,
-                                        kae::Matrix<unsigned, order, order> * pStencilIndices)
+template <class GpuGridT, class ShapeT, class ElemT>
+__device__ thrust::pair<unsigned, unsigned> getGhostPointData(const ElemT *        pCurrPhi,
+                                                              unsigned             i,
+                                                              unsigned             j,
+                                                              CudaFloat2T<ElemT> * pNormals,
+                                                              EBoundaryCondition & boundaryCondition)
 {
-  const unsigned i         = threadIdx.x + blockDim.x * blockIdx.x;
-  const unsigned j         = threadIdx.y + blockDim.y * blockIdx.y;
   const unsigned globalIdx = j * GpuGridT::nx + i;
-  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
-  {
-    return;
-  }
-
   if ((i < 10U) || (j < 10U) || (i >= GpuGridT::nx - 10) || (j >= GpuGridT::ny - 10))
   {
-    return;
+    return {};
   }
 
   ElemT nx = getLevelSetDerivative<GpuGridT, 1U>(pCurrPhi, globalIdx, true);
@@ -48,13 +46,11 @@ __global__ void calculateGhostPointData(const ElemT *                         pC
   const bool pointIsGhost = (level >= 0) && (std::fabs(level) < 5 * GpuGridT::hx);
   if (!pointIsGhost)
   {
-    return;
+    return {};
   }
 
   const CudaFloat2T<ElemT> surfacePoint{ i * GpuGridT::hx - nx * level,  j * GpuGridT::hy - ny * level };
-  pSurfacePoints[globalIdx] = surfacePoint;
-
-  const EBoundaryCondition boundaryCondition = ShapeT::getBoundaryCondition(surfacePoint.x ,surfacePoint.y);
+  boundaryCondition = ShapeT::getBoundaryCondition(surfacePoint.x ,surfacePoint.y);
   if (boundaryCondition == EBoundaryCondition::eWall && level > GpuGridT::hx / 4)
   {
     const ElemT iMirror = i - 2 * nx * level * GpuGridT::hxReciprocal;
@@ -67,30 +63,133 @@ __global__ void calculateGhostPointData(const ElemT *                         pC
     if (sum < static_cast<ElemT>(0.005) * GpuGridT::hx)
     {
       const unsigned mirrorGlobalIdx = jMirrorInt * GpuGridT::nx + iMirrorInt;
-      pClosestIndices[globalIdx]     = thrust::make_pair(globalIdx, mirrorGlobalIdx);;
-      pBoundaryConditions[globalIdx] = EBoundaryCondition::eMirror;
-      return;
+      boundaryCondition = EBoundaryCondition::eMirror;
+      return thrust::make_pair(globalIdx, mirrorGlobalIdx);
     }
   }
 
   const unsigned closestGlobalIdx = getClosestIndex<GpuGridT>(pCurrPhi, i, j, nx, ny);
-  pClosestIndices[globalIdx]      = thrust::make_pair(globalIdx, closestGlobalIdx);
-  pBoundaryConditions[globalIdx]  = boundaryCondition;
-  pStencilIndices[globalIdx]      = getStencilIndices<GpuGridT, order>(pCurrPhi, surfacePoint, { nx, ny });
+  return thrust::make_pair(globalIdx, closestGlobalIdx);
+}
+
+template <class GpuGridT, class ShapeT, class ElemT>
+__global__ void calculateGhostPointData(const ElemT *                      pCurrPhi,
+                                        thrust::pair<unsigned, unsigned> * pClosestIndices,
+                                        std::uint64_t *                    pPartitionKeys,
+                                        unsigned *                         pClosestIndicesCount,
+                                        int8_t *                           pCalculateBlocks,
+                                        const std::uint8_t *               pGeometryMasks,
+                                        std::uint8_t *                     pCellClasses,
+                                        CudaFloat2T<ElemT> *               pNormals)
+{
+  const unsigned i          = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j          = threadIdx.y + blockDim.y * blockIdx.y;
+  const unsigned globalIdx  = j * GpuGridT::nx + i;
+  const bool     isInside   = (i < GpuGridT::nx) && (j < GpuGridT::ny);
+  const bool     isInternal = isInside && (pCurrPhi[globalIdx] < 0);
+
+  if (isInside)
+  {
+    EBoundaryCondition boundaryCondition{ EBoundaryCondition::eWall };
+    const auto indexPair = getGhostPointData<GpuGridT, ShapeT>(pCurrPhi, i, j, pNormals, boundaryCondition);
+    const bool isGhost = (indexPair.first != 0U);
+    if (isGhost)
+    {
+      const unsigned ghostSlot = atomicAdd(pClosestIndicesCount, 1U);
+      pClosestIndices[ghostSlot] = indexPair;
+      pPartitionKeys[ghostSlot]  = getGhostPartitionKey(boundaryCondition, indexPair.second);
+    }
+
+    const bool isChamber = (pGeometryMasks[globalIdx] & GeometryMask::chamber) != 0U;
+    pCellClasses[globalIdx] = static_cast<std::uint8_t>(
+      CellClass::get<GpuGridT>(pCurrPhi[globalIdx]) |
+      (isGhost ? CellClass::getGhost(boundaryCondition) : std::uint8_t{ 0U }) |
+      (isChamber ? std::uint8_t{ 0U } : CellClass::outsideChamber));
+  }
+
+  const int calculateBlock = __syncthreads_or(isInternal);
+  if ((threadIdx.x == 0U) && (threadIdx.y == 0U))
+  {
+    pCalculateBlocks[blockIdx.y * maxSizeX + blockIdx.x] = static_cast<int8_t>(calculateBlock != 0);
+  }
 }
 
-template <class GpuGridT, class ShapeT, unsigned order, class ElemT>
-void calculateGhostPointDataWrapper(thrust::device_ptr<const ElemT>                        pCurrPhi,
-                                    thrust::device_ptr<thrust::pair<unsigned, unsigned>>   pClosestIndices,
-                                    thrust::device_ptr<EBoundaryCondition>                 pBoundaryConditions,
-                                    thrust::device_ptr<CudaFloat2T<ElemT>>                 pNormals,
-                                    thrust::device_ptr<CudaFloat2T<ElemT>>                 pSurfacePoints,
-                                    thrust::device_ptr<kae::Matrix<unsigned, order, order>> pStencilIndices)
+template <class GpuGridT, unsigned order, class ElemT, class PseudoInverseT>
+__global__ void calculateGhostGeometry(const ElemT *                            pCurrPhi,
+                                       const thrust::pair<unsigned, unsigned> * pClosestIndices,
+                                       const std::uint64_t *                    pPartitionKeys,
+                                       const CudaFloat2T<ElemT> *               pNormals,
+                                       CudaFloat2T<ElemT> *                     pSurfacePoints,
+                                       kae::Matrix<unsigned, order, order> *    pStencilIndices,
+                                       PseudoInverseT *                         pPseudoInverses,
+                                       unsigned                                 nClosestIndexElems)
 {
-  calculateGhostPointData<GpuGridT, ShapeT, order><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
-    (pCurrPhi.get(), pClosestIndices.get(), pBoundaryConditions.get(), 
-     pNormals.get(), pSurfacePoints.get(), pStencilIndices.get());
-  cudaDeviceSynchronize();
+  const unsigned ghostSlot = threadIdx.x + blockDim.x * blockIdx.x;
+  if (ghostSlot >= nClosestIndexElems)
+  {
+    return;
+  }
+
+  const unsigned globalIdx = pClosestIndices[ghostSlot].first;
+  const unsigned i         = globalIdx % GpuGridT::nx;
+  const unsigned j         = globalIdx / GpuGridT::nx;
+  const auto     normal    = pNormals[globalIdx];
+  const ElemT    level     = pCurrPhi[globalIdx];
+
+  const CudaFloat2T<ElemT> surfacePoint{ i * GpuGridT::hx - normal.x * level,  j * GpuGridT::hy - normal.y * level };
+  pSurfacePoints[ghostSlot] = surfacePoint;
+  if (getGhostPartitionBoundaryCondition(pPartitionKeys[ghostSlot]) == EBoundaryCondition::eMirror)
+  {
+    return;
+  }
+
+  using IndexMatrixT = kae::Matrix<unsigned, order, order>;
+  const auto stencilIndices  = getStencilIndices<GpuGridT, order>(pCurrPhi, surfacePoint, normal);
+  pStencilIndices[ghostSlot] = stencilIndices;
+  pPseudoInverses[ghostSlot] = getPseudoInverse<GpuGridT>(surfacePoint, normal, 
+                                                          Submatrix<IndexMatrixT, 2U, 2U>{ stencilIndices });
+}
+
+template <class GpuGridT, class ShapeT, class ElemT>
+unsigned calculateGhostPointDataWrapper(thrust::device_ptr<const ElemT>                      pCurrPhi,
+                                        thrust::device_ptr<thrust::pair<unsigned, unsigned>> pClosestIndices,
+                                        thrust::device_ptr<std::uint64_t>                    pPartitionKeys,
+                                        thrust::device_ptr<unsigned>                         pClosestIndicesCount,
+                                        thrust::device_ptr<int8_t>                           pCalculateBlocks,
+                                        thrust::device_ptr<const std::uint8_t>               pGeometryMasks,
+                                        thrust::device_ptr<std::uint8_t>                     pCellClasses,
+                                        thrust::device_ptr<CudaFloat2T<ElemT>>               pNormals)
+{
+  cudaMemset(pClosestIndicesCount.get(), 0, sizeof(unsigned));
+  calculateGhostPointData<GpuGridT, ShapeT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pCurrPhi.get(), pClosestIndices.get(), pPartitionKeys.get(), pClosestIndicesCount.get(), pCalculateBlocks.get(),
+     pGeometryMasks.get(), pCellClasses.get(), pNormals.get());
+
+  unsigned closestIndicesCount{};
+  cudaMemcpy(&closestIndicesCount, pClosestIndicesCount.get(), sizeof(unsigned), cudaMemcpyDeviceToHost);
+  return closestIndicesCount;
+}
+
+template <class GpuGridT, unsigned order, class ElemT, class PseudoInverseT>
+void calculateGhostGeometryWrapper(thrust::device_ptr<const ElemT>                            pCurrPhi,
+                                   thrust::device_ptr<const thrust::pair<unsigned, unsigned>> pClosestIndices,
+                                   thrust::device_ptr<const std::uint64_t>                    pPartitionKeys,
+                                   thrust::device_ptr<const CudaFloat2T<ElemT>>               pNormals,
+                                   thrust::device_ptr<CudaFloat2T<ElemT>>                     pSurfacePoints,
+                                   thrust::device_ptr<kae::Matrix<unsigned, order, order>>    pStencilIndices,
+                                   thrust::device_ptr<PseudoInverseT>                         pPseudoInverses,
+                                   unsigned                                                   nClosestIndexElems)
+{
+  if (nClosestIndexElems == 0U)
+  {
+    return;
+  }
+
+  constexpr unsigned blockSize = 256U;
+  const unsigned gridSize = (nClosestIndexElems + blockSize - 1U) / blockSize;
+  calculateGhostGeometry<GpuGridT, order><<<gridSize, blockSize>>>
+    (pCurrPhi.get(), pClosestIndices.get(), pPartitionKeys.get(), pNormals.get(), pSurfacePoints.get(),
+     pStencilIndices.get(), pPseudoInverses.get(), nClosestIndexElems);
 }
 
 } // namespace detail
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+#include "gas_state.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void calculateDerivedFields(const GasStateT * __restrict__ pGasValues,
+                                       ElemT *           __restrict__ pMach,
+                                       ElemT *           __restrict__ pTemperature)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  const GasStateT gasState = pGasValues[globalIdx];
+  if (pMach)
+  {
+    pMach[globalIdx] = Mach::get(gasState);
+  }
+
+  if (pTemperature)
+  {
+    pTemperature[globalIdx] = Temperature::get(gasState);
+  }
+}
+
+// A null output pointer skips that field, both fields come out of a single read of the gas state.
+template <class GpuGridT, class GasStateT, class ElemT>
+void calculateDerivedFieldsWrapper(thrust::device_ptr<const GasStateT> pGasValues,
+                                   thrust::device_ptr<ElemT>           pMach,
+                                   thrust::device_ptr<ElemT>           pTemperature)
+{
+  calculateDerivedFields<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pGasValues.get(), pMach.get(), pTemperature.get());
+}
+
+} // namespace detail
+
+} // namespace kae
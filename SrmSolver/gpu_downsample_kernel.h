@@ -0,0 +1,72 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+#include "gas_state.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class GpuGridT>
+unsigned getDownsampleFactor(unsigned maxValueCount)
+{
+  unsigned factor{ 1U };
+  while (((GpuGridT::nx + factor - 1U) / factor) * ((GpuGridT::ny + factor - 1U) / factor) > maxValueCount)
+  {
+    ++factor;
+  }
+
+  return factor;
+}
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void downsamplePressure(const GasStateT * __restrict__ pGasValues,
+                                   const ElemT *     __restrict__ pCurrPhi,
+                                   float *           __restrict__ pFrame,
+                                   unsigned                       factor,
+                                   unsigned                       frameNx,
+                                   unsigned                       frameNy)
+{
+  const unsigned fi = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned fj = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((fi >= frameNx) || (fj >= frameNy))
+  {
+    return;
+  }
+
+  ElemT sum{ 0 };
+  unsigned count{ 0U };
+  for (unsigned j{ fj * factor }; (j < (fj + 1U) * factor) && (j < GpuGridT::ny); ++j)
+  {
+    for (unsigned i{ fi * factor }; (i < (fi + 1U) * factor) && (i < GpuGridT::nx); ++i)
+    {
+      const unsigned globalIdx = j * GpuGridT::nx + i;
+      if (pCurrPhi[globalIdx] < 0)
+      {
+        sum += P::get(pGasValues[globalIdx]);
+        ++count;
+      }
+    }
+  }
+
+  pFrame[fj * frameNx + fi] = (count == 0U) ? 0.0f : static_cast<float>(sum / count);
+}
+
+template <class GpuGridT, class GasStateT, class ElemT>
+void downsamplePressureWrapper(thrust::device_ptr<const GasStateT> pGasValues,
+                               thrust::device_ptr<const ElemT>     pCurrPhi,
+                               thrust::device_ptr<float>           pFrame,
+                               unsigned                            factor,
+                               unsigned                            frameNx,
+                               unsigned                            frameNy)
+{
+  const dim3 gridSize{ (frameNx + GpuGridT::blockSize.x - 1U) / GpuGridT::blockSize.x,
+                       (frameNy + GpuGridT::blockSize.y - 1U) / GpuGridT::blockSize.y };
+  downsamplePressure<GpuGridT><<<gridSize, GpuGridT::blockSize>>>
+    (pGasValues.get(), pCurrPhi.get(), pFrame.get(), factor, frameNx, frameNy);
+}
+
+} // namespace detail
+
+} // namespace kae
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+#include "cell_class.h"
+#include "cuda_float_types.h"
+#include "math_utilities.h"
+#include "physical_properties.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class GpuGridT, class ShapeT, class PhysicalPropertiesT, class GasStateT,
+          class ElemT = typename GasStateT::ElemType>
+__global__ void calculateFrontBurningRates(const GasStateT *                        pGasValues,
+                                           const thrust::pair<unsigned, unsigned> * pClosestIndicesMap,
+                                           const CudaFloat2T<ElemT> *               pSurfacePoints,
+                                           ElemT *                                  pFrontRates,
+                                           unsigned                                 nClosestIndexElems)
+{
+  const unsigned ghostSlot = threadIdx.x + blockDim.x * blockIdx.x;
+  if (ghostSlot >= nClosestIndexElems)
+  {
+    return;
+  }
+
+  const auto indexMap     = pClosestIndicesMap[ghostSlot];
+  const auto surfacePoint = pSurfacePoints[ghostSlot];
+  pFrontRates[indexMap.first] = ShapeT::isPointOnGrain(surfacePoint.x, surfacePoint.y) ?
+    BurningRate<PhysicalPropertiesT>{}(pGasValues[indexMap.second]) : static_cast<ElemT>(0);
+}
+
+template <class GpuGridT, class ElemT>
+__global__ void extendBurningRates(const ElemT *              pCurrPhi,
+                                   const CudaFloat2T<ElemT> * pNormals,
+                                   const std::uint8_t *       pCellClasses,
+                                   const ElemT *              pFrontRates,
+                                   ElemT *                    pBurningRates)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  const ElemT    level     = pCurrPhi[globalIdx];
+  if (std::fabs(level) >= 10 * GpuGridT::hx)
+  {
+    pBurningRates[globalIdx] = 0;
+    return;
+  }
+
+  const auto  normal   = pNormals[globalIdx];
+  const ElemT xSurface = i * GpuGridT::hx - normal.x * level;
+  const ElemT ySurface = j * GpuGridT::hy - normal.y * level;
+  const int   iSurface = static_cast<int>(std::round(xSurface * GpuGridT::hxReciprocal));
+  const int   jSurface = static_cast<int>(std::round(ySurface * GpuGridT::hyReciprocal));
+
+  constexpr int searchRadius{ 2 };
+  ElemT minDistanceSquared = 2 * sqr((searchRadius + 1) * GpuGridT::hx);
+  ElemT burningRate{ 0 };
+  for (int jCl = jSurface - searchRadius; jCl <= jSurface + searchRadius; ++jCl)
+  {
+    for (int iCl = iSurface - searchRadius; iCl <= iSurface + searchRadius; ++iCl)
+    {
+      if ((iCl < 0) || (jCl < 0) || (iCl >= static_cast<int>(GpuGridT::nx)) || (jCl >= static_cast<int>(GpuGridT::ny)))
+      {
+        continue;
+      }
+
+      const unsigned clIdx = jCl * GpuGridT::nx + iCl;
+      if (!CellClass::is(pCellClasses[clIdx], CellClass::ghost))
+      {
+        continue;
+      }
+
+      const ElemT distanceSquared = sqr(iCl * GpuGridT::hx - xSurface) + sqr(jCl * GpuGridT::hy - ySurface);
+      if (distanceSquared < minDistanceSquared)
+      {
+        minDistanceSquared = distanceSquared;
+        burningRate        = pFrontRates[clIdx];
+      }
+    }
+  }
+
+  pBurningRates[globalIdx] = burningRate;
+}
+
+template <class GpuGridT, class ShapeT, class PhysicalPropertiesT, class GasStateT,
+          class ElemT = typename GasStateT::ElemType>
+void extendBurningRatesWrapper(thrust::device_ptr<const GasStateT>                        pGasValues,
+                               thrust::device_ptr<const ElemT>                            pCurrPhi,
+                               thrust::device_ptr<const CudaFloat2T<ElemT>>               pNormals,
+                               thrust::device_ptr<const std::uint8_t>                     pCellClasses,
+                               thrust::device_ptr<const thrust::pair<unsigned, unsigned>> pClosestIndicesMap,
+                               thrust::device_ptr<const CudaFloat2T<ElemT>>               pSurfacePoints,
+                               unsigned                                                   nClosestIndexElems,
+                               thrust::device_ptr<ElemT>                                  pFrontRates,
+                               thrust::device_ptr<ElemT>                                  pBurningRates)
+{
+  if (nClosestIndexElems != 0U)
+  {
+    constexpr unsigned blockSize = 64U;
+    const unsigned gridSize = (nClosestIndexElems + blockSize - 1U) / blockSize;
+    calculateFrontBurningRates<GpuGridT, ShapeT, PhysicalPropertiesT><<<gridSize, blockSize>>>
+      (pGasValues.get(), pClosestIndicesMap.get(), pSurfacePoints.get(), pFrontRates.get(), nClosestIndexElems);
+  }
+
+  extendBurningRates<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pCurrPhi.get(), pNormals.get(), pCellClasses.get(), pFrontRates.get(), pBurningRates.get());
+}
+
+} // namespace detail
+
+} // namespace kae
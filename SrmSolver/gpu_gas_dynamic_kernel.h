@@ -2,29 +2,31 @@
 
 #include "cuda_includes.h"
 
+#include "cell_class.h"
 #include "cuda_float_types.h"
 #include "gas_dynamic_flux.h"
 #include "gas_state.h"
+#include "gpu_invalid_tile_tracker.h"
 
 constexpr unsigned maxSizeX = 120U;
 constexpr unsigned maxSizeY = 200U;
-__constant__ int8_t calculateBlockMatrix[maxSizeX * maxSizeY];
 
 namespace kae {
 
 namespace detail {
 
-template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
 __global__ void
 /*__launch_bounds__ (256, 5)*/
 gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
                                               const GasStateT * __restrict__ pFirstValue,
                                               GasStateT *       __restrict__ pCurrValue,
-                                              const ElemT *     __restrict__ pCurrPhi,
-                                              ElemT dt, CudaFloat2T<ElemT> lambda, ElemT prevWeight)
+                                              const std::uint8_t * __restrict__ pCellClasses,
+                                              const ElemT *     __restrict__ pRReciprocals,
+                                              const unsigned *  __restrict__ pActiveTiles,
+                                              ElemT dt, CudaFloat2T<ElemT> lambda, ElemT prevWeight,
+                                              InvalidTileFlags invalidTileFlags)
 {
-  constexpr auto     hx             = GpuGridT::hx;
-  constexpr auto     levelThreshold = 4 * hx;
   constexpr unsigned smx            = GpuGridT::sharedMemory.x;
   constexpr unsigned nx             = GpuGridT::nx;
   constexpr unsigned ny             = GpuGridT::ny;
@@ -41,9 +43,13 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
   const unsigned tj = threadIdx.y;
   const unsigned aj = tj + smExtension;
 
-  const unsigned i = ti + blockDim.x * blockIdx.x;
-  const unsigned j = tj + blockDim.y * blockIdx.y;
-  if ((i >= nx) || (j >= ny) || (calculateBlockMatrix[blockIdx.y * maxSizeX + blockIdx.x] == 0))
+  const unsigned tile  = pActiveTiles[blockIdx.x];
+  const unsigned tileX = tile % GpuGridT::gridSize.x;
+  const unsigned tileY = tile / GpuGridT::gridSize.x;
+
+  const unsigned i = ti + blockDim.x * tileX;
+  const unsigned j = tj + blockDim.y * tileY;
+  if ((i >= nx) || (j >= ny))
   {
     return;
   }
@@ -61,7 +67,7 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
   __shared__ ElemT yFlux3[fluxSmSize];
   __shared__ ElemT yFlux4[fluxSmSize];
 
-  const auto levelValue = __ldg(&pCurrPhi[globalIdx]);
+  const auto cellClass = __ldg(&pCellClasses[globalIdx]);
 
   if ((ti < smExtension) && (i >= smExtension))
   {
@@ -73,7 +79,7 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
     prevMatrix[sharedIdx - smExtension * smx] = pPrevValue[globalIdx - smExtension * nx];
   }
 
-  if (levelValue < levelThreshold)
+  if (CellClass::is(cellClass, CellClass::stencil))
   {
     prevMatrix[sharedIdx] = pPrevValue[globalIdx];
   }
@@ -103,7 +109,7 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
   }
 
   const unsigned fluxSharedIdx = (tj + 1U) * fluxSmx + ti + 1U;
-  const bool fluxShouldBeCalculated = (levelValue <= hx + static_cast<ElemT>(1e-6));
+  const bool fluxShouldBeCalculated = CellClass::is(cellClass, CellClass::flux);
   if (fluxShouldBeCalculated)
   {
     if (tj == 0U)
@@ -127,10 +133,10 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
 
   __syncthreads();
 
-  const bool schemeShouldBeApplied = (levelValue < 0);
+  const bool schemeShouldBeApplied = CellClass::is(cellClass, CellClass::fluid);
   if (schemeShouldBeApplied)
   {
-    const ElemT rReciprocal = 1 / ShapeT::getRadius(i, j);
+    const ElemT rReciprocal = pRReciprocals[globalIdx];
 
     GasStateT calculatedGasState = prevMatrix[sharedIdx];
     CudaFloat4T<ElemT> newConservativeVariables =
@@ -161,19 +167,49 @@ gasDynamicIntegrateTVDSubStep(const GasStateT * __restrict__ pPrevValue,
       newConservativeVariables.w = prevWeight * newConservativeVariables.w + (1 - prevWeight) * RhoEnergy::get(firstGasState);
     }
     calculatedGasState = ConservativeToGasState::get<GasStateT>(newConservativeVariables);
+    markIfNotValid(calculatedGasState, tile, invalidTileFlags);
     pCurrValue[globalIdx] = calculatedGasState;
   }
 }
 
-template <class GpuGridT, class ShapeT, class GasStateT, class ElemT>
+template <class GpuGridT, class GasStateT, class ElemT>
 void gasDynamicIntegrateTVDSubStepWrapper(thrust::device_ptr<const GasStateT> pPrevValue,
                                           thrust::device_ptr<const GasStateT> pFirstValue,
                                           thrust::device_ptr<GasStateT> pCurrValue,
-                                          thrust::device_ptr<const ElemT> pCurrPhi,
-                                          ElemT dt, CudaFloat2T<ElemT> lambda, ElemT pPrevWeight)
+                                          thrust::device_ptr<const std::uint8_t> pCellClasses,
+                                          thrust::device_ptr<const ElemT> pRReciprocals,
+                                          thrust::device_ptr<const unsigned> pActiveTiles,
+                                          unsigned activeTileCount,
+                                          ElemT dt, CudaFloat2T<ElemT> lambda, ElemT pPrevWeight,
+                                          InvalidTileFlags invalidTileFlags = {})
 {
-  gasDynamicIntegrateTVDSubStep<GpuGridT, ShapeT, GasStateT> << <GpuGridT::gridSize, GpuGridT::blockSize >> >
-    (pPrevValue.get(), pFirstValue.get(), pCurrValue.get(), pCurrPhi.get(), dt, lambda, pPrevWeight);
+  if (activeTileCount == 0U)
+  {
+    return;
+  }
+
+  gasDynamicIntegrateTVDSubStep<GpuGridT, GasStateT> << <activeTileCount, GpuGridT::blockSize >> >
+    (pPrevValue.get(), pFirstValue.get(), pCurrValue.get(), pCellClasses.get(), pRReciprocals.get(),
+     pActiveTiles.get(), dt, lambda, pPrevWeight, invalidTileFlags);
+}
+
+template <class GpuGridT>
+unsigned buildActiveTiles(const thrust::device_vector<int8_t> & calculateBlocks,
+                          thrust::device_vector<unsigned> &     activeTiles)
+{
+  constexpr unsigned tileCount = GpuGridT::gridSize.x * GpuGridT::gridSize.y;
+  const auto isActive = [pCalculateBlocks = calculateBlocks.data().get()] __device__ (unsigned tile)
+  {
+    return pCalculateBlocks[(tile / GpuGridT::gridSize.x) * maxSizeX + tile % GpuGridT::gridSize.x] != 0;
+  };
+
+  activeTiles.resize(tileCount);
+  const auto last = thrust::copy_if(thrust::make_counting_iterator(0U),
+                                    thrust::make_counting_iterator(tileCount),
+                                    std::begin(activeTiles),
+                                    isActive);
+  activeTiles.resize(static_cast<std::size_t>(last - std::begin(activeTiles)));
+  return static_cast<unsigned>(activeTiles.size());
 }
 
 } // namespace detail
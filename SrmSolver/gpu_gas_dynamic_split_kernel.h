@@ -0,0 +1,220 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+#include "cell_class.h"
+#include "cuda_float_types.h"
+#include "gas_dynamic_flux.h"
+#include "gas_state.h"
+#include "gpu_gas_dynamic_kernel.h"
+
+namespace kae {
+
+namespace detail {
+
+__forceinline__ HOST_DEVICE bool isFluxFaceActive(std::uint8_t leftCellClass, std::uint8_t rightCellClass)
+{
+  return CellClass::is(leftCellClass, CellClass::flux) || CellClass::is(rightCellClass, CellClass::fluid);
+}
+
+template <class GpuGridT, class GasStateT>
+__global__ void transposeGasStates(const GasStateT * __restrict__ pValue, GasStateT * __restrict__ pTransposedValue)
+{
+  constexpr unsigned nx       = GpuGridT::nx;
+  constexpr unsigned ny       = GpuGridT::ny;
+  constexpr unsigned tileSize = GpuGridT::blockSize.x;
+
+  __shared__ GasStateT tile[tileSize][tileSize + 1U];
+
+  const unsigned i = threadIdx.x + tileSize * blockIdx.x;
+  const unsigned j = threadIdx.y + tileSize * blockIdx.y;
+  for (unsigned k{ 0U }; k < tileSize; k += blockDim.y)
+  {
+    if ((i < nx) && (j + k < ny))
+    {
+      tile[threadIdx.y + k][threadIdx.x] = pValue[(j + k) * nx + i];
+    }
+  }
+
+  __syncthreads();
+
+  const unsigned ti = threadIdx.x + tileSize * blockIdx.y;
+  const unsigned tj = threadIdx.y + tileSize * blockIdx.x;
+  for (unsigned k{ 0U }; k < tileSize; k += blockDim.y)
+  {
+    if ((ti < ny) && (tj + k < nx))
+    {
+      pTransposedValue[(tj + k) * ny + ti] = tile[threadIdx.x][threadIdx.y + k];
+    }
+  }
+}
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void gasDynamicXFluxes(const GasStateT *    __restrict__ pPrevValue,
+                                  const std::uint8_t * __restrict__ pCellClasses,
+                                  CudaFloat4T<ElemT> * __restrict__ pXFluxes,
+                                  ElemT                             lambda)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i < 1U) || (i + 2U >= GpuGridT::nx) || (j >= GpuGridT::ny))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  if (isFluxFaceActive(pCellClasses[globalIdx], pCellClasses[globalIdx + 1U]))
+  {
+    pXFluxes[globalIdx] = getXFluxes<1U, GpuGridT>(pPrevValue, globalIdx, lambda);
+  }
+}
+
+// Works on a tileSize x tileSize tile like transposeGasStates. The cell classes are staged row-major and the states
+// are read from the transposed copy, so both loads are unit-stride. The fluxes are written back row-major through
+// shared memory, which keeps the apply pass unit-stride as well.
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void gasDynamicYFluxes(const GasStateT *    __restrict__ pTransposedPrevValue,
+                                  const std::uint8_t * __restrict__ pCellClasses,
+                                  CudaFloat4T<ElemT> * __restrict__ pYFluxes,
+                                  ElemT                             lambda)
+{
+  constexpr unsigned nx       = GpuGridT::nx;
+  constexpr unsigned ny       = GpuGridT::ny;
+  constexpr unsigned tileSize = GpuGridT::blockSize.x;
+
+  __shared__ std::uint8_t       cellClasses[tileSize + 1U][tileSize + 1U];
+  __shared__ CudaFloat4T<ElemT> fluxes[tileSize][tileSize + 1U];
+  __shared__ bool               isActive[tileSize][tileSize + 1U];
+
+  const unsigned tileI = tileSize * blockIdx.y;
+  const unsigned tileJ = tileSize * blockIdx.x;
+  for (unsigned k{ threadIdx.y }; k < tileSize + 1U; k += blockDim.y)
+  {
+    const unsigned i = tileI + threadIdx.x;
+    const unsigned j = tileJ + k;
+    cellClasses[k][threadIdx.x] = ((i < nx) && (j < ny)) ? pCellClasses[j * nx + i] : std::uint8_t{ 0U };
+  }
+
+  __syncthreads();
+
+  for (unsigned k{ threadIdx.y }; k < tileSize; k += blockDim.y)
+  {
+    const unsigned i = tileI + k;
+    const unsigned j = tileJ + threadIdx.x;
+    const bool active = (j >= 1U) && (j + 2U < ny) && (i < nx) &&
+                        isFluxFaceActive(cellClasses[threadIdx.x][k], cellClasses[threadIdx.x + 1U][k]);
+    isActive[k][threadIdx.x] = active;
+    if (active)
+    {
+      fluxes[k][threadIdx.x] = getYFluxes<1U, GpuGridT>(pTransposedPrevValue, i * ny + j, lambda);
+    }
+  }
+
+  __syncthreads();
+
+  for (unsigned k{ threadIdx.y }; k < tileSize; k += blockDim.y)
+  {
+    const unsigned i = tileI + threadIdx.x;
+    const unsigned j = tileJ + k;
+    if (isActive[threadIdx.x][k])
+    {
+      pYFluxes[j * nx + i] = fluxes[threadIdx.x][k];
+    }
+  }
+}
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void gasDynamicApplyFluxes(const GasStateT *                       pPrevValue,
+                                      const GasStateT *          __restrict__ pFirstValue,
+                                      GasStateT *                             pCurrValue,
+                                      const std::uint8_t *       __restrict__ pCellClasses,
+                                      const ElemT *              __restrict__ pRReciprocals,
+                                      const int8_t *             __restrict__ pCalculateBlocks,
+                                      const CudaFloat4T<ElemT> * __restrict__ pXFluxes,
+                                      const CudaFloat4T<ElemT> * __restrict__ pYFluxes,
+                                      ElemT dt, ElemT prevWeight,
+                                      InvalidTileFlags invalidTileFlags)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  const unsigned j = threadIdx.y + blockDim.y * blockIdx.y;
+  if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny) || (pCalculateBlocks[blockIdx.y * maxSizeX + blockIdx.x] == 0))
+  {
+    return;
+  }
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  if (!CellClass::is(pCellClasses[globalIdx], CellClass::fluid))
+  {
+    return;
+  }
+
+  const auto xFlux     = pXFluxes[globalIdx];
+  const auto prevXFlux = pXFluxes[globalIdx - 1U];
+  const auto yFlux     = pYFluxes[globalIdx];
+  const auto prevYFlux = pYFluxes[globalIdx - GpuGridT::nx];
+
+  const ElemT rReciprocal = pRReciprocals[globalIdx];
+
+  GasStateT calculatedGasState = pPrevValue[globalIdx];
+  CudaFloat4T<ElemT> newConservativeVariables =
+    {
+      Rho::get(calculatedGasState) -
+        dt * GpuGridT::hxReciprocal * (xFlux.x - prevXFlux.x) -
+        dt * GpuGridT::hyReciprocal * (yFlux.x - prevYFlux.x) -
+        dt * rReciprocal * MassFluxY::get(calculatedGasState),
+      MassFluxX::get(calculatedGasState) -
+        dt * GpuGridT::hxReciprocal * (xFlux.y - prevXFlux.y) -
+        dt * GpuGridT::hyReciprocal * (yFlux.y - prevYFlux.y) -
+        dt * rReciprocal * MomentumFluxXy::get(calculatedGasState),
+      MassFluxY::get(calculatedGasState) -
+        dt * GpuGridT::hxReciprocal * (xFlux.z - prevXFlux.z) -
+        dt * GpuGridT::hyReciprocal * (yFlux.z - prevYFlux.z) -
+        dt * rReciprocal * MassFluxY::get(calculatedGasState) * calculatedGasState.uy,
+      RhoEnergy::get(calculatedGasState) -
+        dt * GpuGridT::hxReciprocal * (xFlux.w - prevXFlux.w) -
+        dt * GpuGridT::hyReciprocal * (yFlux.w - prevYFlux.w) -
+        dt * rReciprocal * EnthalpyFluxY::get(calculatedGasState)
+    };
+  if (prevWeight != 1)
+  {
+    const GasStateT firstGasState = pFirstValue[globalIdx];
+    newConservativeVariables.x = prevWeight * newConservativeVariables.x + (1 - prevWeight) * Rho::get(firstGasState);
+    newConservativeVariables.y = prevWeight * newConservativeVariables.y + (1 - prevWeight) * MassFluxX::get(firstGasState);
+    newConservativeVariables.z = prevWeight * newConservativeVariables.z + (1 - prevWeight) * MassFluxY::get(firstGasState);
+    newConservativeVariables.w = prevWeight * newConservativeVariables.w + (1 - prevWeight) * RhoEnergy::get(firstGasState);
+  }
+  const auto newGasState = ConservativeToGasState::get<GasStateT>(newConservativeVariables);
+  markIfNotValid(newGasState, blockIdx.y * GpuGridT::gridSize.x + blockIdx.x, invalidTileFlags);
+  pCurrValue[globalIdx] = newGasState;
+}
+
+template <class GpuGridT, class GasStateT, class ElemT>
+void gasDynamicIntegrateSplitSubStepWrapper(thrust::device_ptr<const GasStateT>     pPrevValue,
+                                            thrust::device_ptr<const GasStateT>     pFirstValue,
+                                            thrust::device_ptr<GasStateT>           pCurrValue,
+                                            thrust::device_ptr<const std::uint8_t>  pCellClasses,
+                                            thrust::device_ptr<const ElemT>         pRReciprocals,
+                                            thrust::device_ptr<const int8_t>        pCalculateBlocks,
+                                            thrust::device_ptr<GasStateT>           pTransposedPrevValue,
+                                            thrust::device_ptr<CudaFloat4T<ElemT>>  pXFluxes,
+                                            thrust::device_ptr<CudaFloat4T<ElemT>>  pYFluxes,
+                                            ElemT dt, CudaFloat2T<ElemT> lambda, ElemT prevWeight,
+                                            InvalidTileFlags invalidTileFlags = {})
+{
+  constexpr unsigned tileSize = GpuGridT::blockSize.x;
+  constexpr dim3 transposeGridSize{ (GpuGridT::nx + tileSize - 1U) / tileSize, (GpuGridT::ny + tileSize - 1U) / tileSize };
+  constexpr dim3 transposedGridSize{ (GpuGridT::ny + tileSize - 1U) / tileSize, (GpuGridT::nx + tileSize - 1U) / tileSize };
+
+  transposeGasStates<GpuGridT><<<transposeGridSize, GpuGridT::blockSize>>>(pPrevValue.get(), pTransposedPrevValue.get());
+  gasDynamicXFluxes<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pPrevValue.get(), pCellClasses.get(), pXFluxes.get(), lambda.x);
+  gasDynamicYFluxes<GpuGridT><<<transposedGridSize, GpuGridT::blockSize>>>
+    (pTransposedPrevValue.get(), pCellClasses.get(), pYFluxes.get(), lambda.y);
+  gasDynamicApplyFluxes<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+    (pPrevValue.get(), pFirstValue.get(), pCurrValue.get(), pCellClasses.get(), pRReciprocals.get(), 
+     pCalculateBlocks.get(), pXFluxes.get(), pYFluxes.get(), dt, prevWeight, invalidTileFlags);
+}
+
+} // namespace detail
+
+} // namespace kae
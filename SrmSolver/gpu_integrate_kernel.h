@@ -88,11 +88,11 @@ void integrateEqTvdSubStepWrapper(thrust::device_ptr<const ElemT> pPrevValue,
                                   thrust::device_ptr<const ElemT> pFirstValue,
                                   thrust::device_ptr<ElemT>       pCurrValue,
                                   thrust::device_ptr<const ElemT> pVelocities,
-                                  ElemT dt, ElemT prevWeight)
+                                  ElemT dt, ElemT prevWeight, cudaStream_t stream)
 {
-  integrateEqTvdSubStep<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
+  integrateEqTvdSubStep<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize, 0U, stream>>>
   (pPrevValue, pFirstValue, pCurrValue, pVelocities, dt, prevWeight);
-  cudaDeviceSynchronize();
+  cudaStreamSynchronize(stream);
 }
 
 } // namespace detail
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "gas_state.h"
+
+namespace kae {
+
+namespace detail {
+
+// Passed by value to the flux sweeps. A tile keeps the tag of the first sub-step that produced a non-finite or
+// non-positive state; pAny points to mapped host memory, so the host polls it without synchronizing the stream.
+struct InvalidTileFlags
+{
+  unsigned * pTiles{ nullptr };
+  unsigned * pAny{ nullptr };
+  unsigned   subStepTag{ 0U };
+};
+
+template <class GasStateT>
+__device__ __forceinline__ void markIfNotValid(const GasStateT & state, unsigned tile, InvalidTileFlags flags)
+{
+  if (flags.pTiles && !IsValid::get(state))
+  {
+    atomicCAS(&flags.pTiles[tile], 0U, flags.subStepTag);
+    *static_cast<volatile unsigned *>(flags.pAny) = 1U;
+  }
+}
+
+} // namespace detail
+
+template <class GpuGridT>
+class GpuInvalidTileTracker
+{
+public:
+
+  constexpr static unsigned tileCount{ GpuGridT::gridSize.x * GpuGridT::gridSize.y };
+
+  GpuInvalidTileTracker();
+  ~GpuInvalidTileTracker();
+
+  GpuInvalidTileTracker(const GpuInvalidTileTracker &) = delete;
+  GpuInvalidTileTracker & operator=(const GpuInvalidTileTracker &) = delete;
+
+  detail::InvalidTileFlags flags(std::uint64_t subStepIndex);
+
+  bool isSet() const { return *static_cast<volatile const unsigned *>(m_pAnyHost) != 0U; }
+
+  // Tiles tagged by the earliest failing sub-step, later tiles are usually contaminated by them.
+  std::vector<unsigned> getFirstInvalidTiles(std::uint64_t & subStepIndex) const;
+  void clear();
+
+private:
+
+  thrust::device_vector<unsigned> m_tiles;
+  unsigned *                      m_pAnyHost{ nullptr };
+  unsigned *                      m_pAnyDevice{ nullptr };
+};
+
+} // namespace kae
+
+#include "gpu_invalid_tile_tracker_def.h"
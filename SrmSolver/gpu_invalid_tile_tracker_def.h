@@ -0,0 +1,68 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+namespace kae {
+
+template <class GpuGridT>
+GpuInvalidTileTracker<GpuGridT>::GpuInvalidTileTracker()
+  : m_tiles(tileCount, 0U)
+{
+  if ((cudaHostAlloc(reinterpret_cast<void **>(&m_pAnyHost), sizeof(unsigned), cudaHostAllocMapped) != cudaSuccess) ||
+      (cudaHostGetDevicePointer(reinterpret_cast<void **>(&m_pAnyDevice), m_pAnyHost, 0U) != cudaSuccess))
+  {
+    cudaFreeHost(m_pAnyHost);
+    throw std::runtime_error("Unable to allocate mapped validity flag");
+  }
+
+  *m_pAnyHost = 0U;
+}
+
+template <class GpuGridT>
+GpuInvalidTileTracker<GpuGridT>::~GpuInvalidTileTracker()
+{
+  cudaFreeHost(m_pAnyHost);
+}
+
+template <class GpuGridT>
+detail::InvalidTileFlags GpuInvalidTileTracker<GpuGridT>::flags(std::uint64_t subStepIndex)
+{
+  return detail::InvalidTileFlags{ m_tiles.data().get(), m_pAnyDevice, static_cast<unsigned>(subStepIndex) + 1U };
+}
+
+template <class GpuGridT>
+std::vector<unsigned> GpuInvalidTileTracker<GpuGridT>::getFirstInvalidTiles(std::uint64_t & subStepIndex) const
+{
+  const thrust::host_vector<unsigned> tags = m_tiles;
+
+  unsigned firstTag{ std::numeric_limits<unsigned>::max() };
+  for (const auto tag : tags)
+  {
+    if (tag != 0U)
+    {
+      firstTag = std::min(firstTag, tag);
+    }
+  }
+
+  std::vector<unsigned> tiles;
+  for (unsigned tile{ 0U }; tile < tileCount; ++tile)
+  {
+    if (tags[tile] == firstTag)
+    {
+      tiles.push_back(tile);
+    }
+  }
+
+  subStepIndex = tiles.empty() ? 0U : firstTag - 1U;
+  return tiles;
+}
+
+template <class GpuGridT>
+void GpuInvalidTileTracker<GpuGridT>::clear()
+{
+  thrust::fill(std::begin(m_tiles), std::end(m_tiles), 0U);
+  *static_cast<volatile unsigned *>(m_pAnyHost) = 0U;
+}
+
+} // namespace kae
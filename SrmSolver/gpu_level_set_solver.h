@@ -1,6 +1,7 @@
 #pragma once
 
 #include "discretization_order.h"
+#include "geometry_planes.h"
 #include "gpu_matrix.h"
 
 namespace kae {
@@ -25,8 +26,12 @@ public:
 
   void reinitialize(unsigned iterationCount, ETimeDiscretizationOrder timeOrder = ETimeDiscretizationOrder::eThree);
 
+  void reset(const GpuMatrix<GpuGridT, ElemType> & state) { m_currState.values() = state.values(); }
+
   const GpuMatrix<GpuGridT, ElemType> & currState() const { return m_currState; }
 
+  void setStream(cudaStream_t stream) { m_stream = stream; }
+
 private:
 
   ElemType integrateInTimeStep(const GpuMatrix<GpuGridT, ElemType> & velocities,
@@ -43,7 +48,8 @@ private:
   GpuMatrix<GpuGridT, ElemType> m_currState;
   GpuMatrix<GpuGridT, ElemType> m_prevState;
   GpuMatrix<GpuGridT, ElemType> m_firstState;
-  GpuMatrix<GpuGridT, ElemType> m_secondState;
+  GpuMatrix<GpuGridT, std::uint8_t> m_schemeMask;
+  cudaStream_t m_stream{ nullptr };
 };
 
 } // namespace kae
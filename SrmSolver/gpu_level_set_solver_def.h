@@ -5,6 +5,7 @@
 
 #include "gpu_integrate_kernel.h"
 #include "gpu_reinitialize_kernel.h"
+#include "sdf_cache.h"
 
 namespace kae {
 
@@ -12,9 +13,38 @@ template <class GpuGridT, class ShapeT>
 GpuLevelSetSolver<GpuGridT, ShapeT>::GpuLevelSetSolver(ShapeT shape, 
                                                        unsigned iterationCount, 
                                                        ETimeDiscretizationOrder timeOrder)
-  : m_currState(shape), m_prevState(shape), m_firstState(shape), m_secondState(shape)
+  : m_currState(shape), m_prevState(shape), m_firstState(shape),
+    m_schemeMask(detail::SchemeMaskInitializer<GpuGridT, ShapeT>{})
 {
+  if (iterationCount == 0U)
+  {
+    return;
+  }
+
+  const auto cacheDirectory = getSdfCacheDirectory();
+  if (cacheDirectory.empty())
+  {
+    reinitialize(iterationCount, timeOrder);
+    return;
+  }
+
+  // The key is taken from the level set this shape instance produced, not from its type alone.
+  constexpr auto valueBytes = GpuGridT::n * sizeof(ElemType);
+  const thrust::host_vector<ElemType> initialValues = m_currState.values();
+  const auto cacheKey = getSdfCacheKey<GpuGridT, ShapeT>(
+    initialValues.data(), valueBytes, iterationCount, static_cast<unsigned>(timeOrder));
+  const SdfCacheFile cacheFile{ cacheDirectory, cacheKey, valueBytes };
+  if (cacheFile.isValid())
+  {
+    const auto pCachedValues = static_cast<const ElemType *>(cacheFile.values());
+    thrust::copy(pCachedValues, pCachedValues + GpuGridT::n, std::begin(m_currState.values()));
+    return;
+  }
+
   reinitialize(iterationCount, timeOrder);
+
+  const thrust::host_vector<ElemType> values = m_currState.values();
+  SdfCacheFile::store(cacheDirectory, cacheKey, values.data(), valueBytes);
 }
 
 template <class GpuGridT, class ShapeT>
@@ -96,7 +126,7 @@ auto GpuLevelSetSolver<GpuGridT, ShapeT>::integrateInTimeStep(
       thrust::device_ptr<const ElemType>{},
       getDevicePtr(m_currState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(1.0));
+      dt, static_cast<ElemType>(1.0), m_stream);
     break;
 
   case ETimeDiscretizationOrder::eTwo:
@@ -105,36 +135,36 @@ auto GpuLevelSetSolver<GpuGridT, ShapeT>::integrateInTimeStep(
       thrust::device_ptr<const ElemType>{},
       getDevicePtr(m_firstState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(1.0));
+      dt, static_cast<ElemType>(1.0), m_stream);
 
     detail::integrateEqTvdSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_firstState),
       getConstDevicePtr(m_prevState),
       getDevicePtr(m_currState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(0.5));
+      dt, static_cast<ElemType>(0.5), m_stream);
     break;
   case ETimeDiscretizationOrder::eThree:
     detail::integrateEqTvdSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_prevState),
       thrust::device_ptr<const ElemType>{},
-      getDevicePtr(m_firstState),
+      getDevicePtr(m_currState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(1.0));
+      dt, static_cast<ElemType>(1.0), m_stream);
 
     detail::integrateEqTvdSubStepWrapper<GpuGridT>(
-      getConstDevicePtr(m_firstState),
+      getConstDevicePtr(m_currState),
       getConstDevicePtr(m_prevState),
-      getDevicePtr(m_secondState),
+      getDevicePtr(m_firstState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(0.25));
+      dt, static_cast<ElemType>(0.25), m_stream);
 
     detail::integrateEqTvdSubStepWrapper<GpuGridT>(
-      getConstDevicePtr(m_secondState),
+      getConstDevicePtr(m_firstState),
       getConstDevicePtr(m_prevState),
       getDevicePtr(m_currState),
       getConstDevicePtr(velocities),
-      dt, static_cast<ElemType>(2.0 / 3.0));
+      dt, static_cast<ElemType>(2.0 / 3.0), m_stream);
     break;
   default:
     break;
@@ -153,43 +183,49 @@ void GpuLevelSetSolver<GpuGridT, ShapeT>::reinitializeStep(ETimeDiscretizationOr
   switch (timeOrder)
   {
   case ETimeDiscretizationOrder::eOne:
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_prevState),
       thrust::device_ptr<const ElemType>{},
       getDevicePtr(m_currState),
-      dt, static_cast<ElemType>(1.0));
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(1.0), m_stream);
     break;
   case ETimeDiscretizationOrder::eTwo:
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_prevState),
       thrust::device_ptr<const ElemType>{},
       getDevicePtr(m_firstState),
-      dt, static_cast<ElemType>(1.0));
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(1.0), m_stream);
 
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_firstState),
       getConstDevicePtr(m_prevState),
       getDevicePtr(m_currState),
-      dt, static_cast<ElemType>(0.5));
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(0.5), m_stream);
     break;
   case ETimeDiscretizationOrder::eThree:
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
       getConstDevicePtr(m_prevState),
       thrust::device_ptr<const ElemType>{},
-      getDevicePtr(m_firstState),
-      dt, static_cast<ElemType>(1.0));
+      getDevicePtr(m_currState),
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(1.0), m_stream);
 
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
-      getConstDevicePtr(m_firstState),
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
+      getConstDevicePtr(m_currState),
       getConstDevicePtr(m_prevState),
-      getDevicePtr(m_secondState),
-      dt, static_cast<ElemType>(0.25));
+      getDevicePtr(m_firstState),
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(0.25), m_stream);
 
-    detail::reinitializeTVDSubStepWrapper<GpuGridT, ShapeT>(
-      getConstDevicePtr(m_secondState),
+    detail::reinitializeTVDSubStepWrapper<GpuGridT>(
+      getConstDevicePtr(m_firstState),
       getConstDevicePtr(m_prevState),
       getDevicePtr(m_currState),
-      dt, static_cast<ElemType>(2.0 / 3.0));
+      getConstDevicePtr(m_schemeMask),
+      dt, static_cast<ElemType>(2.0 / 3.0), m_stream);
     break;
   default:
     break;
@@ -200,7 +236,8 @@ template <class GpuGridT, class ShapeT>
 auto GpuLevelSetSolver<GpuGridT, ShapeT>::getMaxVelocity(const thrust::device_vector<ElemType> & velocities)
   -> ElemType
 {
-  return thrust::reduce(std::begin(velocities),
+  return thrust::reduce(thrust::cuda::par.on(m_stream),
+                        std::begin(velocities),
                         std::end(velocities), 
                         static_cast<ElemType>(0), 
                         thrust::maximum<ElemType>{});
@@ -3,16 +3,19 @@
 #include "std_includes.h"
 #include "cuda_includes.h"
 
+#include "matrix_layout.h"
+
 namespace kae
 {
 
-template <class GpuGridT, class T>
+template <class GpuGridT, class T, class LayoutT = RowMajorLayout<GpuGridT>>
 class GpuMatrix
 {
 public:
 
   using Type        = T;
   using GpuGridType = GpuGridT;
+  using LayoutType  = LayoutT;
 
   GpuMatrix(Type value = {});
   template <class ShapeT, class = std::void_t<decltype(std::declval<ShapeT>()(1U, 2U))>>
@@ -28,25 +31,25 @@ private:
   thrust::device_vector<Type> m_devValues;
 };
 
-template <class GpuGridT, class T>
-thrust::device_ptr<const T> getConstDevicePtr(const GpuMatrix<GpuGridT, T> & matrix)
+template <class GpuGridT, class T, class LayoutT>
+thrust::device_ptr<const T> getConstDevicePtr(const GpuMatrix<GpuGridT, T, LayoutT> & matrix)
 {
   return matrix.values().data();
 }
 
-template <class GpuGridT, class T>
-thrust::device_ptr<const T> getDevicePtr(const GpuMatrix<GpuGridT, T> & matrix)
+template <class GpuGridT, class T, class LayoutT>
+thrust::device_ptr<const T> getDevicePtr(const GpuMatrix<GpuGridT, T, LayoutT> & matrix)
 {
   return matrix.values().data();
 }
 
-template <class GpuGridT, class T>
-thrust::device_ptr<T> getDevicePtr(GpuMatrix<GpuGridT, T> & matrix)
+template <class GpuGridT, class T, class LayoutT>
+thrust::device_ptr<T> getDevicePtr(GpuMatrix<GpuGridT, T, LayoutT> & matrix)
 {
   return matrix.values().data();
 }
 
-template <class GpuGridT, class ShapeT, class ElemT>
+template <class GpuGridT, class LayoutT, class ShapeT, class ElemT>
 __global__ void initializeGpuMatrix(thrust::device_ptr<ElemT> pValues, ShapeT shape)
 {
   const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
@@ -56,30 +59,54 @@ __global__ void initializeGpuMatrix(thrust::device_ptr<ElemT> pValues, ShapeT sh
     return;
   }
 
-  pValues[j * GpuGridT::nx + i] = shape(i, j);
+  pValues[LayoutT::getIndex(i, j)] = shape(i, j);
 }
 
-template <class GpuGridT, class T>
-GpuMatrix<GpuGridT, T>::GpuMatrix(T value)
-  : m_devValues(GpuGridT::n, value)
+template <class GpuGridT, class T, class LayoutT>
+GpuMatrix<GpuGridT, T, LayoutT>::GpuMatrix(T value)
+  : m_devValues(LayoutT::size, value)
 {
 }
 
-template <class GpuGridT, class T>
+template <class GpuGridT, class T, class LayoutT>
 template <class ShapeT, class>
-GpuMatrix<GpuGridT, T>::GpuMatrix(ShapeT shape)
-  : m_devValues(GpuGridT::n)
+GpuMatrix<GpuGridT, T, LayoutT>::GpuMatrix(ShapeT shape)
+  : m_devValues(LayoutT::size)
 {
-  initializeGpuMatrix<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>(m_devValues.data(), shape);
+  initializeGpuMatrix<GpuGridT, LayoutT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>(m_devValues.data(), shape);
   cudaDeviceSynchronize();
 }
 
-template <class GpuGridT, class T>
+// shape.values() is read in row-major order and scattered through LayoutT, padding cells keep T{}.
+template <class GpuGridT, class T, class LayoutT>
 template <class ShapeT, class, class>
-GpuMatrix<GpuGridT, T>::GpuMatrix(ShapeT shape)
-  : m_devValues(GpuGridT::n)
+GpuMatrix<GpuGridT, T, LayoutT>::GpuMatrix(ShapeT shape)
+  : m_devValues(LayoutT::size)
 {
-  thrust::copy(std::begin(shape.values()), std::end(shape.values()), std::begin(m_devValues));
+  const auto & values = shape.values();
+  if (static_cast<std::size_t>(std::distance(std::begin(values), std::end(values))) != GpuGridT::n)
+  {
+    throw std::invalid_argument("Shape values don't match the grid size");
+  }
+
+  if constexpr (std::is_same_v<LayoutT, RowMajorLayout<GpuGridT>>)
+  {
+    thrust::copy(std::begin(values), std::end(values), std::begin(m_devValues));
+  }
+  else
+  {
+    const thrust::host_vector<T> rowMajorValues(std::begin(values), std::end(values));
+    thrust::host_vector<T> layoutValues(LayoutT::size);
+    for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+    {
+      for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+      {
+        layoutValues[LayoutT::getIndex(i, j)] = rowMajorValues[j * GpuGridT::nx + i];
+      }
+    }
+
+    m_devValues = layoutValues;
+  }
 }
 
 } // namespace kae
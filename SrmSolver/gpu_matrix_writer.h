@@ -29,6 +29,36 @@ void writeMatrixToFile(const GpuMatrix<GpuGridT, ElemT> & matrix, const std::str
   }
 }
 
+template <class GpuGridT, class KappaT, class ElemT>
+void writeMatrixToFile(const GpuMatrix<GpuGridT, GasState<KappaT, ElemT>> & matrix,
+                       const std::string & pPath,
+                       const std::string & uxPath,
+                       const std::string & uyPath)
+{
+  std::ofstream pFile(pPath);
+  std::ofstream uxFile(uxPath);
+  std::ofstream uyFile(uyPath);
+  assert(pFile && uxFile && uyFile);
+
+  std::vector<GasState<KappaT, ElemT>> hostValues(GpuGridT::n);
+  auto && deviceValues = matrix.values();
+  thrust::copy(std::begin(deviceValues), std::end(deviceValues), std::begin(hostValues));
+
+  for (unsigned i = 0; i < GpuGridT::nx; ++i)
+  {
+    for (unsigned j = 0; j < GpuGridT::ny; ++j)
+    {
+      ElemT x = i * GpuGridT::hx;
+      ElemT y = j * GpuGridT::hy;
+
+      auto&& gasState = hostValues[j * GpuGridT::nx + i];
+      pFile  << x << ';' << y << ';' << gasState.p  << '\n';
+      uxFile << x << ';' << y << ';' << gasState.ux << '\n';
+      uyFile << x << ';' << y << ';' << gasState.uy << '\n';
+    }
+  }
+}
+
 template <class GpuGridT, class KappaT, class ElemT>
 void writeMatrixToFile(const GpuMatrix<GpuGridT, GasState<KappaT, ElemT>> & matrix,
                        const std::string & pPath,
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "boundary_condition.h"
+
+namespace kae {
+
+namespace detail {
+
+using GhostPartitionOffsets = std::array<unsigned, boundaryConditionCount + 1U>;
+
+inline unsigned getGhostPartitionFirst(const GhostPartitionOffsets & offsets, EBoundaryCondition boundaryCondition)
+{
+  return offsets[static_cast<unsigned>(boundaryCondition)];
+}
+
+inline unsigned getGhostPartitionSize(const GhostPartitionOffsets & offsets, EBoundaryCondition boundaryCondition)
+{
+  const auto idx = static_cast<unsigned>(boundaryCondition);
+  return offsets[idx + 1U] - offsets[idx];
+}
+
+HOST_DEVICE inline std::uint64_t getGhostPartitionKey(EBoundaryCondition boundaryCondition, unsigned closestIdx)
+{
+  return (static_cast<std::uint64_t>(boundaryCondition) << 32U) | closestIdx;
+}
+
+HOST_DEVICE inline EBoundaryCondition getGhostPartitionBoundaryCondition(std::uint64_t partitionKey)
+{
+  return static_cast<EBoundaryCondition>(partitionKey >> 32U);
+}
+
+inline GhostPartitionOffsets partitionGhostPoints(
+  thrust::device_vector<thrust::pair<unsigned, unsigned>> & closestIndicesMap,
+  thrust::device_vector<std::uint64_t> &                    partitionKeys)
+{
+  thrust::sort_by_key(std::begin(partitionKeys), std::end(partitionKeys), std::begin(closestIndicesMap));
+
+  GhostPartitionOffsets offsets{};
+  for (unsigned idx{ 0U }; idx < boundaryConditionCount; ++idx)
+  {
+    const auto first = thrust::lower_bound(std::begin(partitionKeys), 
+                                           std::end(partitionKeys), 
+                                           getGhostPartitionKey(static_cast<EBoundaryCondition>(idx), 0U));
+    offsets[idx] = static_cast<unsigned>(first - std::begin(partitionKeys));
+  }
+  offsets[boundaryConditionCount] = static_cast<unsigned>(partitionKeys.size());
+
+  return offsets;
+}
+
+} // namespace detail
+
+} // namespace kae
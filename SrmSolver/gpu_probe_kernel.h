@@ -0,0 +1,133 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+#include "cell_class.h"
+#include "cuda_float_types.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class ElemT>
+HOST_DEVICE ElemT getFluidWeight(std::uint8_t cellClass, ElemT weight)
+{
+  return CellClass::is(cellClass, CellClass::fluid) ? weight : static_cast<ElemT>(0);
+}
+
+// Used when no corner of the probe's cell is fluid: the closest fluid cell of the first ring around it that has one.
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+HOST_DEVICE GasStateT getNearestFluidState(const GasStateT *    pState,
+                                           const std::uint8_t * pCellClasses,
+                                           ElemT                xi,
+                                           ElemT                yi)
+{
+  const int i0 = static_cast<int>(xi + static_cast<ElemT>(0.5));
+  const int j0 = static_cast<int>(yi + static_cast<ElemT>(0.5));
+  constexpr int maxRadius = static_cast<int>(GpuGridT::nx > GpuGridT::ny ? GpuGridT::nx : GpuGridT::ny);
+  for (int radius{ 1 }; radius < maxRadius; ++radius)
+  {
+    unsigned nearestIdx{ GpuGridT::n };
+    ElemT minDistance{ 0 };
+    for (int j{ j0 - radius }; j <= j0 + radius; ++j)
+    {
+      const int step = ((j == j0 - radius) || (j == j0 + radius)) ? 1 : 2 * radius;
+      for (int i{ i0 - radius }; i <= i0 + radius; i += step)
+      {
+        if ((i < 0) || (j < 0) || (i >= static_cast<int>(GpuGridT::nx)) || (j >= static_cast<int>(GpuGridT::ny)))
+        {
+          continue;
+        }
+
+        const unsigned globalIdx = j * GpuGridT::nx + i;
+        const ElemT dx = (i - xi) * GpuGridT::hx;
+        const ElemT dy = (j - yi) * GpuGridT::hy;
+        const ElemT distance = dx * dx + dy * dy;
+        if (CellClass::is(pCellClasses[globalIdx], CellClass::fluid) &&
+            ((nearestIdx == GpuGridT::n) || (distance < minDistance)))
+        {
+          nearestIdx  = globalIdx;
+          minDistance = distance;
+        }
+      }
+    }
+
+    if (nearestIdx != GpuGridT::n)
+    {
+      return pState[nearestIdx];
+    }
+  }
+
+  return pState[j0 * GpuGridT::nx + i0];
+}
+
+// Bilinear interpolation over the fluid corners of the probe's cell only, with their weights renormalized, so that
+// probes next to the propellant surface don't pick up the solid cells' values.
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+HOST_DEVICE GasStateT getBilinearState(const GasStateT *    pState,
+                                       const std::uint8_t * pCellClasses,
+                                       CudaFloat2T<ElemT>   point)
+{
+  const ElemT xi = thrust::max(thrust::min(point.x * GpuGridT::hxReciprocal, static_cast<ElemT>(GpuGridT::nx - 1U)),
+                               static_cast<ElemT>(0));
+  const ElemT yi = thrust::max(thrust::min(point.y * GpuGridT::hyReciprocal, static_cast<ElemT>(GpuGridT::ny - 1U)),
+                               static_cast<ElemT>(0));
+  const unsigned i = thrust::min(static_cast<unsigned>(xi), GpuGridT::nx - 2U);
+  const unsigned j = thrust::min(static_cast<unsigned>(yi), GpuGridT::ny - 2U);
+  const ElemT fx = xi - i;
+  const ElemT fy = yi - j;
+
+  const unsigned globalIdx = j * GpuGridT::nx + i;
+  const ElemT w00 = getFluidWeight(pCellClasses[globalIdx], (1 - fx) * (1 - fy));
+  const ElemT w10 = getFluidWeight(pCellClasses[globalIdx + 1U], fx * (1 - fy));
+  const ElemT w01 = getFluidWeight(pCellClasses[globalIdx + GpuGridT::nx], (1 - fx) * fy);
+  const ElemT w11 = getFluidWeight(pCellClasses[globalIdx + GpuGridT::nx + 1U], fx * fy);
+  const ElemT weightSum = w00 + w10 + w01 + w11;
+  if (weightSum <= 0)
+  {
+    return getNearestFluidState<GpuGridT>(pState, pCellClasses, xi, yi);
+  }
+
+  const GasStateT & s00 = pState[globalIdx];
+  const GasStateT & s10 = pState[globalIdx + 1U];
+  const GasStateT & s01 = pState[globalIdx + GpuGridT::nx];
+  const GasStateT & s11 = pState[globalIdx + GpuGridT::nx + 1U];
+  const ElemT weightSumReciprocal = 1 / weightSum;
+
+  return GasStateT{ weightSumReciprocal * (w00 * s00.rho + w10 * s10.rho + w01 * s01.rho + w11 * s11.rho),
+                    weightSumReciprocal * (w00 * s00.ux  + w10 * s10.ux  + w01 * s01.ux  + w11 * s11.ux),
+                    weightSumReciprocal * (w00 * s00.uy  + w10 * s10.uy  + w01 * s01.uy  + w11 * s11.uy),
+                    weightSumReciprocal * (w00 * s00.p   + w10 * s10.p   + w01 * s01.p   + w11 * s11.p) };
+}
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__global__ void sampleProbes(const GasStateT *          pState,
+                             const std::uint8_t *       pCellClasses,
+                             const CudaFloat2T<ElemT> * pPoints,
+                             GasStateT *                pSamples,
+                             unsigned                   pointCount)
+{
+  const unsigned pointIdx = threadIdx.x + blockDim.x * blockIdx.x;
+  if (pointIdx >= pointCount)
+  {
+    return;
+  }
+
+  pSamples[pointIdx] = getBilinearState<GpuGridT>(pState, pCellClasses, pPoints[pointIdx]);
+}
+
+template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+void sampleProbesWrapper(thrust::device_ptr<const GasStateT>          pState,
+                         thrust::device_ptr<const std::uint8_t>       pCellClasses,
+                         thrust::device_ptr<const CudaFloat2T<ElemT>> pPoints,
+                         thrust::device_ptr<GasStateT>                pSamples,
+                         unsigned                                     pointCount)
+{
+  constexpr unsigned blockSize = 64U;
+  const unsigned gridSize = (pointCount + blockSize - 1U) / blockSize;
+  sampleProbes<GpuGridT><<<gridSize, blockSize>>>(pState.get(), pCellClasses.get(), pPoints.get(), pSamples.get(), pointCount);
+}
+
+} // namespace detail
+
+} // namespace kae
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include <condition_variable>
+#include <deque>
+
+#include "cuda_float_types.h"
+#include "gpu_matrix.h"
+
+namespace kae {
+
+struct ProbeFileHeader
+{
+  constexpr static std::uint32_t magicValue{ 0x4B414550U };
+  constexpr static std::uint32_t versionValue{ 1U };
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t pointCount;
+  std::uint32_t elemBytes;
+};
+
+// Samples the gas state at fixed points after every gas-dynamic step. Samples stay in a preallocated device ring
+// and are written by a background thread whenever the ring fills up. File layout: ProbeFileHeader, pointCount
+// (x, y) pairs, then one record per step: t followed by rho, ux, uy, p for every point.
+template <class GpuGridT, class GasStateT>
+class GpuProbeRecorder
+{
+public:
+
+  using ElemType = typename GasStateT::ElemType;
+
+  explicit GpuProbeRecorder(const std::wstring & path, unsigned ringCapacity = 4096U);
+  ~GpuProbeRecorder();
+
+  GpuProbeRecorder(const GpuProbeRecorder &) = delete;
+  GpuProbeRecorder & operator=(const GpuProbeRecorder &) = delete;
+
+  // Both return the index of the first added point in every record. Points can't be added once recording started.
+  unsigned addProbe(ElemType x, ElemType y);
+  unsigned addLineSampler(ElemType x0, ElemType y0, ElemType x1, ElemType y1, unsigned pointCount);
+
+  // Only fluid cells contribute to a sample, see detail::getBilinearState.
+  void record(const GpuMatrix<GpuGridT, GasStateT> &    state,
+              const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+              ElemType                                  t);
+  void flush();
+
+  unsigned pointCount() const { return static_cast<unsigned>(m_hostPoints.size()); }
+  std::uint64_t recordedCount() const { return m_recordedCount; }
+
+private:
+
+  void start();
+  void writerLoop();
+
+private:
+
+  std::ofstream                                m_file;
+  unsigned                                     m_ringCapacity;
+  std::vector<CudaFloat2T<ElemType>>           m_hostPoints;
+  thrust::device_vector<CudaFloat2T<ElemType>> m_points;
+  thrust::device_vector<GasStateT>             m_ring;
+  std::vector<ElemType>                        m_times;
+  unsigned                                     m_filledSlots{ 0U };
+  std::uint64_t                                m_recordedCount{ 0U };
+
+  std::mutex                                   m_mutex;
+  std::condition_variable                      m_conditionVariable;
+  std::deque<std::vector<ElemType>>            m_pendingBlocks;
+  bool                                         m_bStop{ false };
+  std::thread                                  m_writer;
+};
+
+} // namespace kae
+
+#include "gpu_probe_recorder_def.h"
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include <filesystem>
+
+#include "gpu_probe_kernel.h"
+
+namespace kae {
+
+template <class GpuGridT, class GasStateT>
+GpuProbeRecorder<GpuGridT, GasStateT>::GpuProbeRecorder(const std::wstring & path, unsigned ringCapacity)
+  : m_file{ std::filesystem::path{ path }, std::ios::binary },
+    m_ringCapacity{ std::max(ringCapacity, 1U) }
+{
+  if (!m_file)
+  {
+    throw std::runtime_error("Unable to open probe file");
+  }
+
+  m_times.reserve(m_ringCapacity);
+}
+
+template <class GpuGridT, class GasStateT>
+GpuProbeRecorder<GpuGridT, GasStateT>::~GpuProbeRecorder()
+{
+  if (!m_writer.joinable())
+  {
+    return;
+  }
+
+  flush();
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_bStop = true;
+  }
+  m_conditionVariable.notify_one();
+  m_writer.join();
+}
+
+template <class GpuGridT, class GasStateT>
+unsigned GpuProbeRecorder<GpuGridT, GasStateT>::addProbe(ElemType x, ElemType y)
+{
+  if (m_writer.joinable())
+  {
+    throw std::logic_error("Probes can't be added after recording started");
+  }
+
+  m_hostPoints.push_back(CudaFloat2T<ElemType>{ x, y });
+  return pointCount() - 1U;
+}
+
+template <class GpuGridT, class GasStateT>
+unsigned GpuProbeRecorder<GpuGridT, GasStateT>::addLineSampler(
+  ElemType x0, ElemType y0, ElemType x1, ElemType y1, unsigned pointCount)
+{
+  if (pointCount < 2U)
+  {
+    throw std::invalid_argument("Line sampler needs at least two points");
+  }
+
+  const auto firstIdx = addProbe(x0, y0);
+  for (unsigned pointIdx{ 1U }; pointIdx < pointCount; ++pointIdx)
+  {
+    const auto alpha = static_cast<ElemType>(pointIdx) / (pointCount - 1U);
+    addProbe(x0 + alpha * (x1 - x0), y0 + alpha * (y1 - y0));
+  }
+
+  return firstIdx;
+}
+
+template <class GpuGridT, class GasStateT>
+void GpuProbeRecorder<GpuGridT, GasStateT>::record(const GpuMatrix<GpuGridT, GasStateT> &    state,
+                                                   const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+                                                   ElemType                                  t)
+{
+  if (m_hostPoints.empty())
+  {
+    return;
+  }
+
+  if (!m_writer.joinable())
+  {
+    start();
+  }
+
+  detail::sampleProbesWrapper<GpuGridT>(
+    getConstDevicePtr(state),
+    getConstDevicePtr(cellClasses),
+    thrust::device_ptr<const CudaFloat2T<ElemType>>{ m_points.data() },
+    m_ring.data() + m_filledSlots * pointCount(),
+    pointCount());
+  m_times.push_back(t);
+  ++m_recordedCount;
+
+  if (++m_filledSlots == m_ringCapacity)
+  {
+    flush();
+  }
+}
+
+template <class GpuGridT, class GasStateT>
+void GpuProbeRecorder<GpuGridT, GasStateT>::flush()
+{
+  if (m_filledSlots == 0U)
+  {
+    return;
+  }
+
+  const thrust::host_vector<GasStateT> samples(std::begin(m_ring),
+                                               std::begin(m_ring) + m_filledSlots * pointCount());
+
+  std::vector<ElemType> block;
+  block.reserve(m_filledSlots * (1U + 4U * pointCount()));
+  for (unsigned slotIdx{ 0U }; slotIdx < m_filledSlots; ++slotIdx)
+  {
+    block.push_back(m_times[slotIdx]);
+    for (unsigned pointIdx{ 0U }; pointIdx < pointCount(); ++pointIdx)
+    {
+      const GasStateT & sample = samples[slotIdx * pointCount() + pointIdx];
+      block.insert(std::end(block), { sample.rho, sample.ux, sample.uy, sample.p });
+    }
+  }
+
+  m_filledSlots = 0U;
+  m_times.clear();
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_pendingBlocks.push_back(std::move(block));
+  }
+  m_conditionVariable.notify_one();
+}
+
+template <class GpuGridT, class GasStateT>
+void GpuProbeRecorder<GpuGridT, GasStateT>::start()
+{
+  m_points = m_hostPoints;
+  m_ring.resize(static_cast<std::size_t>(m_ringCapacity) * pointCount());
+
+  const ProbeFileHeader header{ ProbeFileHeader::magicValue, ProbeFileHeader::versionValue,
+                                pointCount(), static_cast<std::uint32_t>(sizeof(ElemType)) };
+  m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const auto & point : m_hostPoints)
+  {
+    const ElemType coordinates[]{ point.x, point.y };
+    m_file.write(reinterpret_cast<const char *>(coordinates), sizeof(coordinates));
+  }
+
+  m_writer = std::thread{ [this]() { writerLoop(); } };
+}
+
+template <class GpuGridT, class GasStateT>
+void GpuProbeRecorder<GpuGridT, GasStateT>::writerLoop()
+{
+  while (true)
+  {
+    std::vector<ElemType> block;
+    {
+      std::unique_lock<std::mutex> lock{ m_mutex };
+      m_conditionVariable.wait(lock, [this]() { return m_bStop || !m_pendingBlocks.empty(); });
+      if (m_pendingBlocks.empty())
+      {
+        break;
+      }
+
+      block = std::move(m_pendingBlocks.front());
+      m_pendingBlocks.pop_front();
+    }
+
+    m_file.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(ElemType));
+  }
+
+  m_file.flush();
+}
+
+} // namespace kae
@@ -8,10 +8,11 @@ namespace kae {
 
 namespace detail {
 
-template <class GpuGridT, class ShapeT, class ElemT>
-__global__ void reinitializeTVDSubStep(thrust::device_ptr<const ElemT> pPrevValue,
-                                       thrust::device_ptr<const ElemT> pFirstValue,
-                                       thrust::device_ptr<ElemT>       pCurrValue,
+template <class GpuGridT, class ElemT>
+__global__ void reinitializeTVDSubStep(thrust::device_ptr<const ElemT>        pPrevValue,
+                                       thrust::device_ptr<const ElemT>        pFirstValue,
+                                       thrust::device_ptr<ElemT>              pCurrValue,
+                                       thrust::device_ptr<const std::uint8_t> pSchemeMask,
                                        ElemT dt, ElemT prevWeight)
 {
   const unsigned ti        = threadIdx.x;
@@ -61,7 +62,7 @@ __global__ void reinitializeTVDSubStep(thrust::device_ptr<const ElemT> pPrevValu
                                      (i < GpuGridT::nx - GpuGridT::smExtension - 2) && 
                                      (j > GpuGridT::smExtension + 1) && 
                                      (j < GpuGridT::ny - GpuGridT::smExtension - 2) && 
-                                      ShapeT::shouldApplyScheme(i, j);
+                                     (pSchemeMask[globalIdx] != 0U);
 
   if (schemeShouldBeApplied)
   {
@@ -81,15 +82,16 @@ __global__ void reinitializeTVDSubStep(thrust::device_ptr<const ElemT> pPrevValu
   }
 }
 
-template <class GpuGridT, class ShapeT, class ElemT>
-void reinitializeTVDSubStepWrapper(thrust::device_ptr<const ElemT> pPrevValue,
-                                   thrust::device_ptr<const ElemT> pFirstValue,
-                                   thrust::device_ptr<ElemT>       pCurrValue,
-                                   ElemT dt, ElemT prevWeight)
+template <class GpuGridT, class ElemT>
+void reinitializeTVDSubStepWrapper(thrust::device_ptr<const ElemT>        pPrevValue,
+                                   thrust::device_ptr<const ElemT>        pFirstValue,
+                                   thrust::device_ptr<ElemT>              pCurrValue,
+                                   thrust::device_ptr<const std::uint8_t> pSchemeMask,
+                                   ElemT dt, ElemT prevWeight, cudaStream_t stream)
 {
-  reinitializeTVDSubStep<GpuGridT, ShapeT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>
-  (pPrevValue, pFirstValue, pCurrValue, dt, prevWeight);
-  cudaDeviceSynchronize();
+  reinitializeTVDSubStep<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize, 0U, stream>>>
+  (pPrevValue, pFirstValue, pCurrValue, pSchemeMask, dt, prevWeight);
+  cudaStreamSynchronize(stream);
 }
 
 } // namespace detail
@@ -2,21 +2,63 @@
 
 #include "cuda_includes.h"
 
+#pragma warning(push, 0)
+#include <cooperative_groups.h>
+#pragma warning(pop)
+
 #include "boundary_condition.h"
 #include "cuda_float_types.h"
 #include "gas_state.h"
 #include "get_extrapolated_ghost_value.h"
+#include "gpu_partition_ghost_points_kernel.h"
 
 namespace kae {
 
 namespace detail {
 
-template <class GpuGridT, class GasStateT, class PhysicalPropertiesT, class ElemT = typename GasStateT::ElemType>
+// The inlet ghosts of a warp pool their solve and iteration counts in the first active lane, so a warp issues one
+// pair of global atomics instead of one pair per ghost. Coalesced groups stay correct for the partial tail warp.
+__device__ __forceinline__ void addMassFlowCounters(unsigned long long * pMassFlowCounters, unsigned iterationCount)
+{
+  namespace cg = cooperative_groups;
+
+  const auto activeGroup = cg::coalesced_threads();
+  unsigned long long iterationSum{ 0ULL };
+  for (unsigned rank{ 0U }; rank < activeGroup.size(); ++rank)
+  {
+    iterationSum += activeGroup.shfl(iterationCount, rank);
+  }
+
+  if (activeGroup.thread_rank() == 0U)
+  {
+    atomicAdd(pMassFlowCounters, static_cast<unsigned long long>(activeGroup.size()));
+    atomicAdd(pMassFlowCounters + 1U, iterationSum);
+  }
+}
+
+template <class PhysicalPropertiesT, class GasStateT, class ElemT = typename GasStateT::ElemType>
+__device__ GasStateT getCachedMassFlowExtrapolatedGhostValue(const GasStateT &    gasState,
+                                                             const GasStateT &    closestGasState,
+                                                             ElemT *              pMassFlowPressure,
+                                                             unsigned long long * pMassFlowCounters)
+{
+  ElemT p1 = *pMassFlowPressure;
+  unsigned iterationCount{ 0U };
+  const auto massFlowState = getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesT>(
+    gasState, closestGasState, p1, iterationCount);
+
+  *pMassFlowPressure = IsValid::get(massFlowState) ? p1 : static_cast<ElemT>(0);
+  addMassFlowCounters(pMassFlowCounters, iterationCount);
+  return massFlowState;
+}
+
+template <class GpuGridT, class GasStateT, class PhysicalPropertiesT, EBoundaryCondition boundaryCondition,
+          class ElemT = typename GasStateT::ElemType>
 __global__ void setFirstOrderGhostValues(thrust::device_ptr<GasStateT>                              pGasValues,
-                                         thrust::device_ptr<const ElemT>                            pCurrPhi,
                                          thrust::device_ptr<const thrust::pair<unsigned, unsigned>> pClosestIndicesMap,
-                                         thrust::device_ptr<const EBoundaryCondition>               pBoundaryConditions,
-                                         thrust::device_ptr<CudaFloat2T<ElemT>>                  pNormals,
+                                         thrust::device_ptr<CudaFloat2T<ElemT>>                     pNormals,
+                                         thrust::device_ptr<ElemT>                                  pMassFlowPressures,
+                                         thrust::device_ptr<unsigned long long>                     pMassFlowCounters,
                                          unsigned                                                   nClosestIndexElems)
 {
   const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
@@ -28,27 +70,59 @@ __global__ void setFirstOrderGhostValues(thrust::device_ptr<GasStateT>
   const auto indexMap             = pClosestIndicesMap.get()[i];
   const unsigned globalIdx        = indexMap.first;
   const unsigned closestGlobalIdx = indexMap.second;
-  const auto boundaryCondition = pBoundaryConditions.get()[globalIdx];
   const auto normal            = pNormals.get()[globalIdx];
   const auto rotatedState      = Rotate::get(pGasValues.get()[closestGlobalIdx], normal.x, normal.y);
+  if (boundaryCondition == EBoundaryCondition::eMassFlowInlet)
+  {
+    const auto massFlowState = getCachedMassFlowExtrapolatedGhostValue<PhysicalPropertiesT>(
+      rotatedState, rotatedState, pMassFlowPressures.get() + globalIdx, pMassFlowCounters.get());
+    pGasValues[globalIdx] = ReverseRotate::get(massFlowState, normal.x, normal.y);
+    return;
+  }
+
   const auto extrapolatedState = getFirstOrderExtrapolatedGhostValue<PhysicalPropertiesT>(rotatedState, 
                                                                                           rotatedState,
                                                                                           boundaryCondition);
   pGasValues[globalIdx]        = ReverseRotate::get(extrapolatedState, normal.x, normal.y);
 }
 
-template <class GpuGridT, class GasStateT, class PhysicalPropertiesT, class ElemT>
+template <class GpuGridT, class GasStateT, class PhysicalPropertiesT, EBoundaryCondition boundaryCondition, class ElemT>
 void setFirstOrderGhostValuesWrapper(thrust::device_ptr<GasStateT>                              pGasValues,
-                                     thrust::device_ptr<const ElemT>                            pCurrPhi,
                                      thrust::device_ptr<const thrust::pair<unsigned, unsigned>> pClosestIndices,
-                                     thrust::device_ptr<const EBoundaryCondition>               pBoundaryConditions,
-                                     thrust::device_ptr<CudaFloat2T<ElemT>>                  pNormals,
-                                     unsigned nClosestIndexElems)
+                                     thrust::device_ptr<CudaFloat2T<ElemT>>                     pNormals,
+                                     thrust::device_ptr<ElemT>                                  pMassFlowPressures,
+                                     thrust::device_ptr<unsigned long long>                     pMassFlowCounters,
+                                     const GhostPartitionOffsets &                              ghostPartitionOffsets)
 {
+  const unsigned nClosestIndexElems = getGhostPartitionSize(ghostPartitionOffsets, boundaryCondition);
+  if (nClosestIndexElems == 0U)
+  {
+    return;
+  }
+
   constexpr unsigned blockSize = 256U;
   const unsigned gridSize = (nClosestIndexElems + blockSize - 1U) / blockSize;
-  setFirstOrderGhostValues<GpuGridT, GasStateT, PhysicalPropertiesT><<<gridSize, blockSize>>>
-  (pGasValues, pCurrPhi, pClosestIndices, pBoundaryConditions, pNormals, nClosestIndexElems);
+  setFirstOrderGhostValues<GpuGridT, GasStateT, PhysicalPropertiesT, boundaryCondition><<<gridSize, blockSize>>>
+  (pGasValues, pClosestIndices + getGhostPartitionFirst(ghostPartitionOffsets, boundaryCondition), pNormals,
+   pMassFlowPressures, pMassFlowCounters, nClosestIndexElems);
+}
+
+template <class GpuGridT, class GasStateT, class PhysicalPropertiesT, class ElemT>
+void setFirstOrderGhostValuesWrapper(thrust::device_ptr<GasStateT>                              pGasValues,
+                                     thrust::device_ptr<const thrust::pair<unsigned, unsigned>> pClosestIndices,
+                                     thrust::device_ptr<CudaFloat2T<ElemT>>                     pNormals,
+                                     thrust::device_ptr<ElemT>                                  pMassFlowPressures,
+                                     thrust::device_ptr<unsigned long long>                     pMassFlowCounters,
+                                     const GhostPartitionOffsets &                              ghostPartitionOffsets)
+{
+  setFirstOrderGhostValuesWrapper<GpuGridT, GasStateT, PhysicalPropertiesT, EBoundaryCondition::eWall>(
+    pGasValues, pClosestIndices, pNormals, pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setFirstOrderGhostValuesWrapper<GpuGridT, GasStateT, PhysicalPropertiesT, EBoundaryCondition::ePressureOutlet>(
+    pGasValues, pClosestIndices, pNormals, pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setFirstOrderGhostValuesWrapper<GpuGridT, GasStateT, PhysicalPropertiesT, EBoundaryCondition::eMassFlowInlet>(
+    pGasValues, pClosestIndices, pNormals, pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setFirstOrderGhostValuesWrapper<GpuGridT, GasStateT, PhysicalPropertiesT, EBoundaryCondition::eMirror>(
+    pGasValues, pClosestIndices, pNormals, pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
 }
 
 } // namespace detail
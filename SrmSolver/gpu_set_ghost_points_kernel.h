@@ -8,6 +8,7 @@
 #include "get_coordinates_matrix.h"
 #include "get_extrapolated_ghost_value.h"
 #include "get_polynomial.h"
+#include "gpu_set_first_order_ghost_points_kernel.h"
 #include "matrix_operations.h"
 
 template <class T>
@@ -27,13 +28,16 @@ namespace kae {
 namespace detail {
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT, unsigned order, unsigned smSizeX,
-          class InputMatrixT, class ElemT = typename GasStateT::ElemType>
+          EBoundaryCondition boundaryCondition, class InputMatrixT, class PseudoInverseT,
+          class ElemT = typename GasStateT::ElemType>
 __global__ void setGhostValues(GasStateT *                              pGasValues,
                                const thrust::pair<unsigned, unsigned> * pClosestIndicesMap,
-                               const EBoundaryCondition *               pBoundaryConditions,
-                               CudaFloat2T<ElemT> *                     pNormals,
-                               CudaFloat2T<ElemT> *                     pSurfacePoints,
-                               InputMatrixT *                           pIndexMatrix,
+                               const CudaFloat2T<ElemT> *               pNormals,
+                               const CudaFloat2T<ElemT> *               pSurfacePoints,
+                               const InputMatrixT *                     pIndexMatrix,
+                               const PseudoInverseT *                   pPseudoInverses,
+                               ElemT *                                  pMassFlowPressures,
+                               unsigned long long *                     pMassFlowCounters,
                                unsigned                                 nClosestIndexElems)
 {
   const auto i = threadIdx.x + blockDim.x * blockIdx.x;
@@ -45,15 +49,15 @@ __global__ void setGhostValues(GasStateT *                              pGasValu
   const auto indexMap            = pClosestIndicesMap[i];
   const auto ghostIdx            = indexMap.first;
   const auto closestIdx          = indexMap.second;
-  const auto surfacePoint        = pSurfacePoints[ghostIdx];
+  const auto surfacePoint        = pSurfacePoints[i];
   const auto normal              = pNormals[ghostIdx];
 
   const auto rotatedClosestState = Rotate::get(pGasValues[closestIdx], normal.x, normal.y);
-  const auto boundaryCondition   = pBoundaryConditions[ghostIdx];
   const auto closestSonic        = SonicSpeed::get(rotatedClosestState);
 
-  const auto indexMatrix = pIndexMatrix[ghostIdx];
-  const auto x = getWenoPolynomial<GpuGridT>(surfacePoint, normal, pGasValues, indexMatrix);
+  const auto indexMatrix   = pIndexMatrix[i];
+  const auto pseudoInverse = pPseudoInverses[i];
+  const auto x = getCachedWenoPolynomial<GpuGridT>(surfacePoint, normal, pseudoInverse, pGasValues, indexMatrix);
 
   const auto ghostI = ghostIdx % GpuGridT::nx;
   const auto ghostJ = ghostIdx / GpuGridT::nx;
@@ -100,7 +104,8 @@ __global__ void setGhostValues(GasStateT *                              pGasValu
     constexpr auto one   = static_cast<ElemT>(1);
 
     const auto extrapolatedGasState = GasStateT{ x(0, 0), x(0, 1), x(0, 2), x(0, 3) };
-    const auto mfs   = getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesT>(extrapolatedGasState, rotatedClosestState);
+    const auto mfs   = getCachedMassFlowExtrapolatedGhostValue<PhysicalPropertiesT>(
+      extrapolatedGasState, rotatedClosestState, pMassFlowPressures + ghostIdx, pMassFlowCounters);
     const auto unSqr = sqr(mfs.ux);
     const auto cSqr  = kappa * mfs.p / mfs.rho;
 
@@ -136,20 +141,58 @@ __global__ void setGhostValues(GasStateT *                              pGasValu
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT, unsigned order,
-          class InputMatrixT, class ElemT = typename GasStateT::ElemType>
+          EBoundaryCondition boundaryCondition, class InputMatrixT, class PseudoInverseT,
+          class ElemT = typename GasStateT::ElemType>
 void setGhostValuesWrapper(DevicePtr<GasStateT>                              pGasValues,
                            DevicePtr<const thrust::pair<unsigned, unsigned>> pClosestIndices,
-                           DevicePtr<const EBoundaryCondition>               pBoundaryConditions,
                            DevicePtr<CudaFloat2T<ElemT>>                     pNormals,
                            DevicePtr<CudaFloat2T<ElemT>>                     pSurfacePoints,
                            DevicePtr<InputMatrixT>                           pIndexMatrix,
-                           unsigned                                          nClosestIndexElems)
+                           DevicePtr<PseudoInverseT>                         pPseudoInverses,
+                           DevicePtr<ElemT>                                  pMassFlowPressures,
+                           DevicePtr<unsigned long long>                     pMassFlowCounters,
+                           const GhostPartitionOffsets &                     ghostPartitionOffsets)
 {
+  const unsigned nClosestIndexElems = getGhostPartitionSize(ghostPartitionOffsets, boundaryCondition);
+  if (nClosestIndexElems == 0U)
+  {
+    return;
+  }
+
   constexpr unsigned blockSize = 64U;
   const unsigned gridSize = (nClosestIndexElems + blockSize - 1U) / blockSize;
-  setGhostValues<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, blockSize><<<gridSize, blockSize>>>
-  (pGasValues.get(), pClosestIndices.get(), pBoundaryConditions.get(), pNormals.get(), 
-    pSurfacePoints.get(), pIndexMatrix.get(), nClosestIndexElems);
+  const unsigned first    = getGhostPartitionFirst(ghostPartitionOffsets, boundaryCondition);
+  setGhostValues<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, blockSize, boundaryCondition>
+  <<<gridSize, blockSize>>>
+  (pGasValues.get(), pClosestIndices.get() + first, pNormals.get(), pSurfacePoints.get() + first,
+    pIndexMatrix.get() + first, pPseudoInverses.get() + first, pMassFlowPressures.get(),
+    pMassFlowCounters.get(), nClosestIndexElems);
+}
+
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT, unsigned order,
+          class InputMatrixT, class PseudoInverseT, class ElemT = typename GasStateT::ElemType>
+void setGhostValuesWrapper(DevicePtr<GasStateT>                              pGasValues,
+                           DevicePtr<const thrust::pair<unsigned, unsigned>> pClosestIndices,
+                           DevicePtr<CudaFloat2T<ElemT>>                     pNormals,
+                           DevicePtr<CudaFloat2T<ElemT>>                     pSurfacePoints,
+                           DevicePtr<InputMatrixT>                           pIndexMatrix,
+                           DevicePtr<PseudoInverseT>                         pPseudoInverses,
+                           DevicePtr<ElemT>                                  pMassFlowPressures,
+                           DevicePtr<unsigned long long>                     pMassFlowCounters,
+                           const GhostPartitionOffsets &                     ghostPartitionOffsets)
+{
+  setGhostValuesWrapper<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, EBoundaryCondition::eWall>(
+    pGasValues, pClosestIndices, pNormals, pSurfacePoints, pIndexMatrix, pPseudoInverses,
+    pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setGhostValuesWrapper<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, EBoundaryCondition::ePressureOutlet>(
+    pGasValues, pClosestIndices, pNormals, pSurfacePoints, pIndexMatrix, pPseudoInverses,
+    pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setGhostValuesWrapper<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, EBoundaryCondition::eMassFlowInlet>(
+    pGasValues, pClosestIndices, pNormals, pSurfacePoints, pIndexMatrix, pPseudoInverses,
+    pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
+  setGhostValuesWrapper<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order, EBoundaryCondition::eMirror>(
+    pGasValues, pClosestIndices, pNormals, pSurfacePoints, pIndexMatrix, pPseudoInverses,
+    pMassFlowPressures, pMassFlowCounters, ghostPartitionOffsets);
 }
 
 } // namespace detail
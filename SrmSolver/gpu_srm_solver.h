@@ -1,10 +1,18 @@
 #pragma once
 
+#include "analysis_pipeline.h"
 #include "boundary_condition.h"
+#include "cell_class.h"
 #include "cuda_float_types.h"
 #include "empty_callback.h"
+#include "flux_sweep.h"
+#include "geometry_planes.h"
+#include "gpu_invalid_tile_tracker.h"
 #include "gpu_level_set_solver.h"
 #include "gpu_matrix.h"
+#include "gpu_partition_ghost_points_kernel.h"
+#include "gpu_probe_recorder.h"
+#include "solver_stats.h"
 
 namespace kae {
 
@@ -20,10 +28,11 @@ public:
   static_assert(std::is_same<typename GasStateType::ElemType, typename GpuGridT::ElemType>::value, 
                 "Error! Precisions differ.");
 
-  GpuSrmSolver(ShapeT    shape, 
-               GasStateT initialState, 
-               unsigned  iterationCount = 0U, 
-               ElemType  courant = static_cast<ElemType>(0.8));
+  GpuSrmSolver(ShapeT     shape, 
+               GasStateT  initialState, 
+               unsigned   iterationCount = 0U, 
+               ElemType   courant = static_cast<ElemType>(0.8),
+               EFluxSweep fluxSweep = EFluxSweep::eFused);
 
   template <class CallbackT = detail::EmptyCallback>
   void quasiStationaryDynamicIntegrate(unsigned                 iterationCount, 
@@ -37,6 +46,12 @@ public:
                         ETimeDiscretizationOrder timeOrder, 
                         CallbackT &&             callback = CallbackT{});
 
+  template <class CallbackT = detail::EmptyCallback>
+  void laggedDynamicIntegrate(unsigned                 iterationCount, 
+                              ElemType                 deltaT, 
+                              ETimeDiscretizationOrder timeOrder, 
+                              CallbackT &&             callback = CallbackT{});
+
   template <class CallbackT = detail::EmptyCallback>
   ElemType staticIntegrate(unsigned                 iterationCount,
                            ETimeDiscretizationOrder timeOrder, 
@@ -50,34 +65,73 @@ public:
   const GpuMatrix<GpuGridT, GasStateType> & currState() const { return m_currState; }
   const GpuMatrix<GpuGridT, ElemType>     & currPhi()   const { return m_levelSetSolver.currState(); }
 
+  SolverStats stats() const;
+  void resetStats();
+
+  // Brings a warm solver back to its initial state without reallocating its workspaces.
+  void reset(const GpuMatrix<GpuGridT, ElemType> & initialPhi, GasStateT initialState, ElemType courant);
+
+  // The recorder samples the state after every gas-dynamic step, nullptr detaches it. It isn't owned by the solver.
+  void setProbeRecorder(GpuProbeRecorder<GpuGridT, GasStateT> * pProbeRecorder) { m_pProbeRecorder = pProbeRecorder; }
+  ElemType time() const { return m_time; }
+
 private:
 
+  template <class CallbackT>
+  void analyze(CallbackT & pipeline, unsigned i, ElemType t, const GpuMatrix<GpuGridT, ElemType> & phi);
   ElemType staticIntegrateStep(ETimeDiscretizationOrder timeOrder, ElemType dt, CudaFloat2T<ElemType> lambdas);
+  void integrateSubStep(thrust::device_ptr<GasStateType>       pPrevValue,
+                        thrust::device_ptr<const GasStateType> pFirstValue,
+                        thrust::device_ptr<GasStateType>       pCurrValue,
+                        ElemType                               dt,
+                        CudaFloat2T<ElemType>                  lambdas,
+                        ElemType                               prevWeight);
   ElemType integrateInTime(ElemType deltaT);
+  const GpuMatrix<GpuGridT, ElemType> & updateBurningRates(const GpuMatrix<GpuGridT, ElemType> & phi);
   CudaFloat4T<ElemType> getMaxEquationDerivatives() const;
   void findClosestIndices();
-  void fillCalculateBlockMatrix();
-  void writeIfNotValid() const;
+  void writeIfNotValid(ETimeDiscretizationOrder timeOrder, ElemType dt, CudaFloat2T<ElemType> lambdas);
 
 private:
 
   constexpr static unsigned order{ 2U };
-  using IndexMatrixT = kae::Matrix<unsigned, order, order>;
+  using IndexMatrixT         = kae::Matrix<unsigned, order, order>;
+  using PseudoInverseMatrixT = kae::Matrix<ElemType, 3U, 4U>;
 
-  GpuMatrix<GpuGridT, EBoundaryCondition>       m_boundaryConditions;
   GpuMatrix<GpuGridT, CudaFloat2T<ElemType>>    m_normals;
-  GpuMatrix<GpuGridT, CudaFloat2T<ElemType>>    m_surfacePoints;
-  GpuMatrix<GpuGridT, IndexMatrixT>             m_indexMatrices;
+  GpuMatrix<GpuGridT, ElemType>                 m_massFlowPressures;
+  GpuMatrix<GpuGridT, ElemType>                 m_burningRates;
+  GpuMatrix<GpuGridT, ElemType>                 m_frontBurningRates;
   GpuMatrix<GpuGridT, GasStateType>             m_currState;
   GpuMatrix<GpuGridT, GasStateType>             m_prevState;
-  GpuMatrix<GpuGridT, GasStateType>             m_firstState;
-  GpuMatrix<GpuGridT, GasStateType>             m_secondState;
   GpuLevelSetSolver<GpuGridT, ShapeT>           m_levelSetSolver;
+  GeometryPlanes<GpuGridT, ShapeT>              m_geometryPlanes;
+  GpuMatrix<GpuGridT, std::uint8_t>             m_cellClasses;
 
   thrust::device_vector<thrust::pair<unsigned, unsigned>> m_closestIndicesMap;
-  std::vector<int8_t> m_calculateBlocks;
+  thrust::device_vector<unsigned> m_ghostPointsCount;
+  thrust::device_vector<int8_t> m_calculateBlocks;
+  thrust::device_vector<unsigned> m_activeTiles;
+  thrust::device_vector<unsigned long long> m_massFlowCounters;
+  thrust::device_vector<std::uint64_t> m_ghostPartitionKeys;
+  thrust::device_vector<CudaFloat2T<ElemType>> m_surfacePoints;
+  thrust::device_vector<IndexMatrixT> m_indexMatrices;
+  thrust::device_vector<PseudoInverseMatrixT> m_pseudoInverses;
+  detail::GhostPartitionOffsets m_ghostPartitionOffsets{};
+  GpuInvalidTileTracker<GpuGridT> m_invalidTiles;
+  std::optional<GpuMatrix<GpuGridT, ElemType>> m_machField;
+  std::optional<GpuMatrix<GpuGridT, ElemType>> m_temperatureField;
 
   ElemType m_courant{ static_cast<ElemType>(0.8) };
+  EFluxSweep m_fluxSweep{ EFluxSweep::eFused };
+  std::uint64_t m_subStepCount{ 0U };
+  ElemType m_time{ 0 };
+  GpuProbeRecorder<GpuGridT, GasStateT> * m_pProbeRecorder{ nullptr };
+
+  thrust::device_vector<GasStateType>          m_stageState;
+  thrust::device_vector<GasStateType>          m_transposedState;
+  thrust::device_vector<CudaFloat4T<ElemType>> m_xFluxes;
+  thrust::device_vector<CudaFloat4T<ElemType>> m_yFluxes;
 };
 
 } // namespace kae
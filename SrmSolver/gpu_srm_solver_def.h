@@ -4,12 +4,16 @@
 #include "cuda_includes.h"
 
 #include "gas_state.h"
-#include "gpu_build_ghost_to_closest_map_kernel.h"
+#include "gpu_derived_fields_kernel.h"
 #include "gpu_calculate_ghost_point_data_kernel.h"
+#include "gpu_extend_burning_rates_kernel.h"
 #include "gpu_gas_dynamic_kernel.h"
+#include "gpu_gas_dynamic_split_kernel.h"
 #include "gpu_matrix_writer.h"
+#include "gpu_partition_ghost_points_kernel.h"
 #include "gpu_set_first_order_ghost_points_kernel.h"
 #include "gpu_set_ghost_points_kernel.h"
+#include "invalid_tiles_writer.h"
 #include "solver_reduction_functions.h"
 
 template <class T>
@@ -37,97 +41,88 @@ template <class GpuGridT,
           unsigned order,
           class GasStateT,
           class IndexMatrixT,
+          class PseudoInverseT,
           class ElemT = typename GpuGridT::ElemType>
 void srmIntegrateTVDSubStepWrapper(DevicePtr<GasStateT>                              pPrevValue,
                                    DevicePtr<const GasStateT>                        pFirstValue,
                                    DevicePtr<GasStateT>                              pCurrValue,
-                                   DevicePtr<const ElemT>                            pCurrentPhi,
+                                   DevicePtr<const std::uint8_t>                     pCellClasses,
+                                   DevicePtr<const ElemT>                            pRReciprocals,
+                                   DevicePtr<const int8_t>                           pCalculateBlocks,
+                                   DevicePtr<const unsigned>                         pActiveTiles,
+                                   std::size_t                                       activeTileCount,
                                    DevicePtr<const thrust::pair<unsigned, unsigned>> pClosestIndicesMap,
-                                   DevicePtr<const EBoundaryCondition>               pBoundaryConditions,
                                    DevicePtr<CudaFloat2T<ElemT>>                     pNormals,
                                    DevicePtr<CudaFloat2T<ElemT>>                     pSurfacePoints,
                                    DevicePtr<IndexMatrixT>                           pIndexMatrices,
-                                   unsigned nClosestIndexElems, ElemT dt, CudaFloat2T<ElemT> lambda, ElemT prevWeight)
+                                   DevicePtr<PseudoInverseT>                         pPseudoInverses,
+                                   DevicePtr<ElemT>                                  pMassFlowPressures,
+                                   DevicePtr<unsigned long long>                     pMassFlowCounters,
+                                   const GhostPartitionOffsets &                     ghostPartitionOffsets,
+                                   EFluxSweep                                        fluxSweep,
+                                   DevicePtr<GasStateT>                              pTransposedPrevValue,
+                                   DevicePtr<CudaFloat4T<ElemT>>                     pXFluxes,
+                                   DevicePtr<CudaFloat4T<ElemT>>                     pYFluxes,
+                                   InvalidTileFlags                                  invalidTileFlags,
+                                   std::uint64_t                                     subStepIndex,
+                                   ElemT dt, CudaFloat2T<ElemT> lambda, ElemT prevWeight)
 {
   constexpr std::uint64_t startIdx{ 200U };
-  static thread_local std::uint64_t counter{};
 
-  /*if (counter > startIdx)
+  /*if (subStepIndex > startIdx)
   {
     detail::setGhostValuesWrapper<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT, order>(
       pPrevValue,
       pClosestIndicesMap,
-      pBoundaryConditions,
       pNormals,
       pSurfacePoints,
       pIndexMatrices,
-      nClosestIndexElems);
+      pPseudoInverses,
+      pMassFlowPressures,
+      pMassFlowCounters,
+      ghostPartitionOffsets);
   }
   else*/
   {
-    ++counter;
     detail::setFirstOrderGhostValuesWrapper<GpuGridT, GasStateT, PhysicalPropertiesT>(
       pPrevValue,
-      pCurrentPhi,
       pClosestIndicesMap,
-      pBoundaryConditions,
       pNormals,
-      nClosestIndexElems);
+      pMassFlowPressures,
+      pMassFlowCounters,
+      ghostPartitionOffsets);
   }
 
-
-  detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, GasStateT>(
-    pPrevValue,
-    pFirstValue,
-    pCurrValue,
-    pCurrentPhi,
-    dt, lambda, prevWeight);
-}
-
-template <class ShapeT,
-          class PhysicalPropertiesT,
-          class GpuGridT,
-          class GasStateT,
-          class ElemT = typename GasStateT::ElemType>
-GpuMatrix<GpuGridT, ElemT> getBurningRates(const GpuMatrix<GpuGridT, GasStateT>            & currState,
-                                           const GpuMatrix<GpuGridT, ElemT>                & currPhi,
-                                           const GpuMatrix<GpuGridT, CudaFloat2T<ElemT>>   & normals)
-{
-  const static thread_local auto indices = generateIndexMatrix<unsigned>(GpuGridT::n);
-
-  const auto zipFirst = thrust::make_zip_iterator(
-    thrust::make_tuple(std::begin(currState.values()), 
-                       std::begin(indices), 
-                       std::begin(currPhi.values()), 
-                       std::begin(normals.values())));
-  const auto zipLast = thrust::make_zip_iterator(
-    thrust::make_tuple(std::end(currState.values()), 
-                       std::end(indices), 
-                       std::end(currPhi.values()), 
-                       std::end(normals.values())));
-
-  const auto toBurningRate = [] __device__
-    (const thrust::tuple<GasStateT, unsigned, ElemT, CudaFloat2T<ElemT>> & tuple)
+  switch (fluxSweep)
   {
-    const auto index = thrust::get<1U>(tuple);
-    const auto i = index % GpuGridT::nx;
-    const auto j = index / GpuGridT::nx;
-    if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny))
-    {
-      return static_cast<ElemT>(0.0);
-    }
-
-    const auto level = thrust::get<2U>(tuple);
-    const auto normal = thrust::get<3U>(tuple);
-    const auto isBurningSurface = ShapeT::isPointOnGrain(i * GpuGridT::hx - level * normal.x,
-                                                         j * GpuGridT::hy - level * normal.y);
-    const auto burningRate = BurningRate<PhysicalPropertiesT>{}(thrust::get<0U>(tuple));
-    return (isBurningSurface ? burningRate : static_cast<ElemT>(0));
-  };
-
-  GpuMatrix<GpuGridT, ElemT> burningRates;
-  thrust::transform(zipFirst, zipLast, std::begin(burningRates.values()), toBurningRate);
-  return burningRates;
+  case EFluxSweep::eDimensionallySplit:
+    detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+      pPrevValue,
+      pFirstValue,
+      pCurrValue,
+      pCellClasses,
+      pRReciprocals,
+      pCalculateBlocks,
+      pTransposedPrevValue,
+      pXFluxes,
+      pYFluxes,
+      dt, lambda, prevWeight,
+      invalidTileFlags);
+    break;
+  case EFluxSweep::eFused:
+  default:
+    detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, GasStateT>(
+      pPrevValue,
+      pFirstValue,
+      pCurrValue,
+      pCellClasses,
+      pRReciprocals,
+      pActiveTiles,
+      static_cast<unsigned>(activeTileCount),
+      dt, lambda, prevWeight,
+      invalidTileFlags);
+    break;
+  }
 }
 
 } // namespace detail
@@ -136,20 +131,28 @@ template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertie
 GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::GpuSrmSolver(
   ShapeT    shape, 
   GasStateT initialState,
-  unsigned  iterationCount,
-  ElemType  courant)
-  : m_boundaryConditions{ EBoundaryCondition::eWall                               },
-    m_normals           { CudaFloat2T<ElemType>{ 0, 0 }                           },
-    m_surfacePoints     { CudaFloat2T<ElemType>{ 0, 0 }                           },
-    m_indexMatrices     { IndexMatrixT{}                                          },
+  unsigned   iterationCount,
+  ElemType   courant,
+  EFluxSweep fluxSweep)
+  : m_normals           { CudaFloat2T<ElemType>{ 0, 0 }                           },
+    m_massFlowPressures { static_cast<ElemType>(0)                                },
+    m_burningRates      { static_cast<ElemType>(0)                                },
+    m_frontBurningRates { static_cast<ElemType>(0)                                },
     m_currState         { initialState                                            },
     m_prevState         { initialState                                            },
-    m_firstState        { initialState                                            },
-    m_secondState       { initialState                                            },
     m_levelSetSolver    { shape, iterationCount, ETimeDiscretizationOrder::eThree },
+    m_geometryPlanes    {                                                         },
+    m_cellClasses       { std::uint8_t{ 0U }                                      },
     m_closestIndicesMap ( GpuGridT::n, thrust::make_pair(0U, 0U)                  ),
+    m_ghostPointsCount  ( 1U, 0U                                                  ),
     m_calculateBlocks   ( maxSizeX * maxSizeY, 0                                  ),
-    m_courant           { courant                                                 }
+    m_massFlowCounters  ( 2U, 0ULL                                                ),
+    m_courant           { courant                                                 },
+    m_fluxSweep         { fluxSweep                                               },
+    m_stageState        ( (fluxSweep == EFluxSweep::eDimensionallySplit) ? 0U : GpuGridT::n, initialState ),
+    m_transposedState   ( (fluxSweep == EFluxSweep::eDimensionallySplit) ? GpuGridT::n : 0U ),
+    m_xFluxes           ( (fluxSweep == EFluxSweep::eDimensionallySplit) ? GpuGridT::n : 0U ),
+    m_yFluxes           ( (fluxSweep == EFluxSweep::eDimensionallySplit) ? GpuGridT::n : 0U )
 {
   findClosestIndices();
 }
@@ -169,18 +172,23 @@ void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::quasiStatio
   for (unsigned i{ 0U }; i < iterationCount; ++i)
   {
     prevP = std::exchange(currP,
-      detail::getTheoreticalBoriPressure<GpuGridT, ShapeT, PhysicalPropertiesT>(phiValues, m_normals.values()));
-    const auto sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(phiValues, m_normals.values());
-    const auto chamberVolume = detail::getChamberVolume<GpuGridT, ShapeT>(phiValues);
+      detail::getTheoreticalBoriPressure<GpuGridT, ShapeT, PhysicalPropertiesT>(phiValues, m_normals.values(), 
+                                                                               m_geometryPlanes));
+    const auto chamberVolume = detail::getChamberVolume<GpuGridT, ShapeT>(m_cellClasses.values(), m_geometryPlanes);
     desiredIntegrateTime += 450 * std::fabs(prevP - currP) * chamberVolume + levelSetDeltaT / 100;
     const auto gasDynamicDeltaT = std::min(desiredIntegrateTime, levelSetDeltaT);
     desiredIntegrateTime -= gasDynamicDeltaT;
 
-    staticIntegrate(gasDynamicDeltaT, timeOrder, callback);
-    if (i % 100 == 0)
+    staticIntegrate(gasDynamicDeltaT, timeOrder, detail::getInnerCallback(callback));
+    if constexpr (detail::IsAnalysisPipelineV<CallbackT>)
     {
+      analyze(callback, i, t, currPhi());
+    }
+    else if (!detail::IsEmptyCallbackV<CallbackT> && (i % 100 == 0))
+    {
+      const auto sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(phiValues, m_normals.values(), m_geometryPlanes);
       cudaStreamSynchronize(nullptr);
-      callback(m_currState, currPhi(), i, t, getMaxEquationDerivatives(), sBurn, ShapeT{});
+      callback(m_currState, currPhi(), i, t, getMaxEquationDerivatives(), sBurn, m_cellClasses, m_geometryPlanes);
     }
     const auto dt = integrateInTime(levelSetDeltaT);
     t += dt;
@@ -195,18 +203,86 @@ void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::dynamicInte
   auto t{ static_cast<ElemType>(0.0) };
   for (unsigned i{ 0U }; i < iterationCount; ++i)
   {
-    const auto deltaTGasDynamic = staticIntegrate(deltaT, timeOrder, callback);
-    const auto maxDerivatives = getMaxEquationDerivatives();
-    const auto sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(currPhi().values(), m_normals.values());
-    if (i % 10 == 0)
+    const auto deltaTGasDynamic = staticIntegrate(deltaT, timeOrder, detail::getInnerCallback(callback));
+    if constexpr (detail::IsAnalysisPipelineV<CallbackT>)
     {
-      callback(m_currState, currPhi(), i, t, getMaxEquationDerivatives(), sBurn, ShapeT{});
+      analyze(callback, i, t, currPhi());
+    }
+    else if (!detail::IsEmptyCallbackV<CallbackT> && (i % 10 == 0))
+    {
+      const auto sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(currPhi().values(), m_normals.values(), 
+                                                                     m_geometryPlanes);
+      callback(m_currState, currPhi(), i, t, getMaxEquationDerivatives(), sBurn, m_cellClasses, m_geometryPlanes);
     }
     const auto dt = integrateInTime(deltaTGasDynamic);
     t += dt;
   }
 }
 
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+template <class CallbackT>
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::laggedDynamicIntegrate(
+  unsigned iterationCount, ElemType deltaT, ETimeDiscretizationOrder timeOrder, CallbackT && callback)
+{
+  cudaStream_t levelSetStream{};
+  cudaStreamCreateWithFlags(&levelSetStream, cudaStreamNonBlocking);
+  m_levelSetSolver.setStream(levelSetStream);
+  const auto resetLevelSetStream = [this, levelSetStream]()
+  {
+    m_levelSetSolver.setStream(nullptr);
+    cudaStreamDestroy(levelSetStream);
+  };
+
+  GpuMatrix<GpuGridT, ElemType> laggedPhi{ currPhi() };
+  auto && innerCallback = detail::getInnerCallback(callback);
+  const auto staticCallback = [&innerCallback, &laggedPhi](const auto & gasState, const auto &)
+  {
+    innerCallback(gasState, laggedPhi);
+  };
+
+  try
+  {
+    auto t{ static_cast<ElemType>(0.0) };
+    auto gasDynamicT{ static_cast<ElemType>(0.0) };
+    for (unsigned i{ 0U }; i < iterationCount; ++i)
+    {
+      laggedPhi.values() = currPhi().values();
+      const auto & burningRates = updateBurningRates(laggedPhi);
+      cudaStreamSynchronize(nullptr);
+
+      // The level set runs alongside the gas step, so it catches up with the gas time integrated so far. The clocks
+      // stay apart by at most what a single staticIntegrate call misses deltaT by.
+      const auto levelSetDeltaT = std::max(deltaT + gasDynamicT - t, static_cast<ElemType>(0.0));
+      auto levelSetStep = std::async(std::launch::async, [this, &burningRates, levelSetDeltaT]()
+      {
+        return m_levelSetSolver.integrateInTime(burningRates, levelSetDeltaT, ETimeDiscretizationOrder::eThree);
+      });
+
+      gasDynamicT += staticIntegrate(deltaT, timeOrder, staticCallback);
+      if constexpr (detail::IsAnalysisPipelineV<CallbackT>)
+      {
+        analyze(callback, i, t, laggedPhi);
+      }
+      else if (!detail::IsEmptyCallbackV<CallbackT> && (i % 10 == 0))
+      {
+        const auto sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(laggedPhi.values(), m_normals.values(), 
+                                                                       m_geometryPlanes);
+        callback(m_currState, laggedPhi, i, t, getMaxEquationDerivatives(), sBurn, m_cellClasses, m_geometryPlanes);
+      }
+
+      t += levelSetStep.get();
+      findClosestIndices();
+    }
+  }
+  catch (...)
+  {
+    resetLevelSetStream();
+    throw;
+  }
+
+  resetLevelSetStream();
+}
+
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
 template <class CallbackT>
 auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticIntegrate(
@@ -214,8 +290,6 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticInteg
   ETimeDiscretizationOrder timeOrder,
   CallbackT && callback) -> ElemType
 {
-  findClosestIndices();
-
   auto t{ static_cast<ElemType>(0.0) };
   CudaFloat2T<ElemType> lambdas{};
   for (unsigned i{ 0U }; i < iterationCount; ++i)
@@ -229,7 +303,11 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticInteg
     staticIntegrateStep(timeOrder, dt, lambdas);
     t += dt;
 
-    if (i % 200U == 0U)
+    if constexpr (detail::IsAnalysisPipelineV<CallbackT>)
+    {
+      analyze(callback, i, t, currPhi());
+    }
+    else if (!detail::IsEmptyCallbackV<CallbackT> && (i % 200U == 0U))
     {
       cudaStreamSynchronize(nullptr);
       callback(m_currState, currPhi());
@@ -250,8 +328,6 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticInteg
   ETimeDiscretizationOrder timeOrder, 
   CallbackT && callback) -> ElemType
 {
-  findClosestIndices();
-
   unsigned i{ 0U };
   auto t{ static_cast<ElemType>(0.0) };
   CudaFloat2T<ElemType> lambdas;
@@ -267,109 +343,142 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticInteg
     auto dt = std::min(maxDt, remainingTime);
     dt = staticIntegrateStep(timeOrder, dt, lambdas);
     t += dt;
-    ++i;
-    if (i % 200U == 0U)
+    if constexpr (detail::IsAnalysisPipelineV<CallbackT>)
     {
+      analyze(callback, i, t, currPhi());
+    }
+    else if (!detail::IsEmptyCallbackV<CallbackT> && (i % 200U == 0U))
+    {
+      cudaStreamSynchronize(nullptr);
       callback(m_currState, currPhi());
     }
     if (i % 5000U == 0U)
     {
       std::cout << i << ": " << t << '\n';
     }
+    ++i;
   }
 
   return t;
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
-void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::findClosestIndices()
+SolverStats GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::stats() const
 {
-  m_closestIndicesMap.resize(GpuGridT::n);
-  thrust::fill(std::begin(m_closestIndicesMap), 
-               std::end(m_closestIndicesMap), 
-               thrust::pair<unsigned, unsigned>{0U, 0U});
-  detail::calculateGhostPointDataWrapper<GpuGridT, ShapeT, order>(
-    getDevicePtr(currPhi()),
-    m_closestIndicesMap.data(),
-    getDevicePtr(m_boundaryConditions),
-    getDevicePtr(m_normals),
-    getDevicePtr(m_surfacePoints),
-    getDevicePtr(m_indexMatrices));
-
-  const auto removeIter = thrust::remove_if(std::begin(m_closestIndicesMap), 
-                                            std::end(m_closestIndicesMap),
-                                            thrust::placeholders::_1 == thrust::pair<unsigned, unsigned>{0U, 0U});
-  m_closestIndicesMap.erase(removeIter, std::end(m_closestIndicesMap));
-  fillCalculateBlockMatrix();
+  const thrust::host_vector<unsigned long long> massFlowCounters = m_massFlowCounters;
+  return SolverStats{ massFlowCounters[0U], massFlowCounters[1U] };
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
-void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::fillCalculateBlockMatrix()
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::resetStats()
 {
-  static_assert(maxSizeX >= GpuGridT::gridSize.x, "Error. Max size is too small!");
-  static_assert(maxSizeY >= GpuGridT::gridSize.y, "Error. Max size is too small!");
+  thrust::fill(std::begin(m_massFlowCounters), std::end(m_massFlowCounters), 0ULL);
+}
 
-  thrust::host_vector<ElemType> currentLevel = currPhi().values();
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::reset(
+  const GpuMatrix<GpuGridT, ElemType> & initialPhi, GasStateT initialState, ElemType courant)
+{
+  m_levelSetSolver.reset(initialPhi);
+  thrust::fill(std::begin(m_currState.values()), std::end(m_currState.values()), initialState);
+  thrust::fill(std::begin(m_prevState.values()), std::end(m_prevState.values()), initialState);
+  thrust::fill(std::begin(m_stageState), std::end(m_stageState), initialState);
+  thrust::fill(std::begin(m_normals.values()), std::end(m_normals.values()), CudaFloat2T<ElemType>{ 0, 0 });
+  thrust::fill(std::begin(m_massFlowPressures.values()), std::end(m_massFlowPressures.values()), static_cast<ElemType>(0));
+  thrust::fill(std::begin(m_burningRates.values()), std::end(m_burningRates.values()), static_cast<ElemType>(0));
+  thrust::fill(std::begin(m_frontBurningRates.values()), std::end(m_frontBurningRates.values()), static_cast<ElemType>(0));
+  m_courant      = courant;
+  m_subStepCount = 0U;
+  m_time         = 0;
+  m_invalidTiles.clear();
+  resetStats();
+  findClosestIndices();
+}
 
-  for (unsigned blockIdxX{ 0U }; blockIdxX < GpuGridT::gridSize.x; ++blockIdxX)
-  {
-    const auto startX = blockIdxX * GpuGridT::blockSize.x;
-    for (unsigned blockIdxY{ 0U }; blockIdxY < GpuGridT::gridSize.y; ++blockIdxY)
-    {
-      const auto startY = blockIdxY * GpuGridT::blockSize.y;
-      bool calculateBlock{ false };
-      for (unsigned xIdx{ 0U }; (xIdx < GpuGridT::blockSize.x) && !calculateBlock; ++xIdx)
-      {
-        for (unsigned yIdx{ 0U }; (yIdx < GpuGridT::blockSize.y) && !calculateBlock; ++yIdx)
-        {
-          const auto index = (startY + yIdx) * GpuGridT::nx + startX + xIdx;
-          if ((index < GpuGridT::n) && (currentLevel[index] < 0))
-          {
-            calculateBlock = true;
-          }
-        }
-      }
-      if (calculateBlock)
-      {
-        m_calculateBlocks.at(blockIdxY * maxSizeX + blockIdxX) = 1;
-      }
-    }
-  }
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::findClosestIndices()
+{
+  static_assert(maxSizeX >= GpuGridT::gridSize.x, "Error. Max size is too small!");
+  static_assert(maxSizeY >= GpuGridT::gridSize.y, "Error. Max size is too small!");
 
-  cudaMemcpyToSymbol(calculateBlockMatrix, m_calculateBlocks.data(), sizeof(int8_t) * maxSizeX * maxSizeY);
+  m_closestIndicesMap.resize(GpuGridT::n);
+  m_ghostPartitionKeys.resize(GpuGridT::n);
+  const auto closestIndicesCount = detail::calculateGhostPointDataWrapper<GpuGridT, ShapeT>(
+    getDevicePtr(currPhi()),
+    m_closestIndicesMap.data(),
+    m_ghostPartitionKeys.data(),
+    m_ghostPointsCount.data(),
+    m_calculateBlocks.data(),
+    getDevicePtr(m_geometryPlanes.masks()),
+    getDevicePtr(m_cellClasses),
+    getDevicePtr(m_normals));
+
+  m_closestIndicesMap.resize(closestIndicesCount);
+  m_ghostPartitionKeys.resize(closestIndicesCount);
+  m_ghostPartitionOffsets = detail::partitionGhostPoints(m_closestIndicesMap, m_ghostPartitionKeys);
+
+  m_surfacePoints.resize(closestIndicesCount);
+  m_indexMatrices.resize(closestIndicesCount);
+  m_pseudoInverses.resize(closestIndicesCount);
+  detail::calculateGhostGeometryWrapper<GpuGridT, order>(
+    getDevicePtr(currPhi()),
+    m_closestIndicesMap.data(),
+    m_ghostPartitionKeys.data(),
+    getConstDevicePtr(m_normals),
+    m_surfacePoints.data(),
+    m_indexMatrices.data(),
+    m_pseudoInverses.data(),
+    closestIndicesCount);
+  detail::buildActiveTiles<GpuGridT>(m_calculateBlocks, m_activeTiles);
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
-void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::writeIfNotValid() const
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::writeIfNotValid(
+  ETimeDiscretizationOrder timeOrder, ElemType dt, CudaFloat2T<ElemType> lambdas)
 {
-  if (thrust::all_of(std::begin(m_currState.values()), std::end(m_currState.values()), kae::IsValid{}))
+  if (!m_invalidTiles.isSet())
   {
     return;
   }
 
-  writeMatrixToFile(m_prevState, 
-                    "prev_error_p.dat", 
-                    "prev_error_ux.dat", 
-                    "prev_error_uy.dat", 
-                    "prev_error_mach.dat", 
-                    "prev_error_t.dat");
-  writeMatrixToFile(m_currState, 
-                    "curr_error_p.dat", 
-                    "curr_error_ux.dat", 
-                    "curr_error_uy.dat", 
-                    "curr_error_mach.dat", 
-                    "curr_error_t.dat");
-  writeMatrixToFile(currPhi(), "sgd.dat");
+  // The flag may be seen a few steps after the failure, the tiles tagged first still point to its origin.
+  cudaStreamSynchronize(nullptr);
+  std::uint64_t firstSubStepIndex{ 0U };
+  const auto tiles = m_invalidTiles.getFirstInvalidTiles(firstSubStepIndex);
+
+  std::ofstream file{ "invalid_tiles.dat" };
+  file << "# first invalid sub-step " << firstSubStepIndex << ", current sub-step " << m_subStepCount
+       << ", t = " << m_time << ", dt = " << dt << ", lambdas = " << lambdas.x << ' ' << lambdas.y
+       << ", courant = " << m_courant << ", time order = " << static_cast<int>(timeOrder)
+       << ", flux sweep = " << static_cast<int>(m_fluxSweep) << '\n';
+  writeInvalidTiles(file, tiles, m_prevState, m_currState, currPhi());
   throw std::runtime_error("Gas state has become invalid");
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
 auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::integrateInTime(ElemType deltaT) -> ElemType
 {
-  const auto burningRates = detail::getBurningRates<ShapeT, PhysicalPropertiesT>(
-    m_currState, currPhi(), m_normals);
-  return m_levelSetSolver.integrateInTime(
-    burningRates, deltaT, ETimeDiscretizationOrder::eThree);
+  const auto & burningRates = updateBurningRates(currPhi());
+  const auto dt = m_levelSetSolver.integrateInTime(burningRates, deltaT, ETimeDiscretizationOrder::eThree);
+  findClosestIndices();
+  return dt;
+}
+
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::updateBurningRates(
+  const GpuMatrix<GpuGridT, ElemType> & phi) -> const GpuMatrix<GpuGridT, ElemType> &
+{
+  detail::extendBurningRatesWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, GasStateT, ElemType>(
+    getConstDevicePtr(m_currState),
+    getConstDevicePtr(phi),
+    getConstDevicePtr(m_normals),
+    getConstDevicePtr(m_cellClasses),
+    m_closestIndicesMap.data(),
+    m_surfacePoints.data(),
+    static_cast<unsigned>(m_closestIndicesMap.size()),
+    getDevicePtr(m_frontBurningRates),
+    getDevicePtr(m_burningRates));
+  return m_burningRates;
 }
 
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
@@ -382,6 +491,59 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::getMaxEquat
     detail::getDeltaT<GpuGridT>(m_currState.values(), m_courant));
 }
 
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+template <class CallbackT>
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::analyze(
+  CallbackT & pipeline, unsigned i, ElemType t, const GpuMatrix<GpuGridT, ElemType> & phi)
+{
+  if (!pipeline.isDue(i))
+  {
+    return;
+  }
+
+  const auto quantities = pipeline.getRequiredQuantities(i);
+  AnalysisFrame<GpuGridT, GasStateT> frame{ i, t, m_currState, phi };
+  if (AnalysisQuantity::is(quantities, AnalysisQuantity::maxDerivatives))
+  {
+    frame.maxDerivatives = getMaxEquationDerivatives();
+  }
+
+  if (AnalysisQuantity::is(quantities, AnalysisQuantity::burningSurface | AnalysisQuantity::integrals))
+  {
+    frame.sBurn = detail::getBurningSurface<GpuGridT, ShapeT>(phi.values(), m_normals.values(), m_geometryPlanes);
+  }
+
+  if (AnalysisQuantity::is(quantities, AnalysisQuantity::integrals))
+  {
+    frame.integrals = detail::getIntegralData(m_currState, m_cellClasses, m_geometryPlanes, t, *frame.sBurn);
+  }
+
+  const bool machRequested        = AnalysisQuantity::is(quantities, AnalysisQuantity::mach);
+  const bool temperatureRequested = AnalysisQuantity::is(quantities, AnalysisQuantity::temperature);
+  if (machRequested && !m_machField)
+  {
+    m_machField.emplace(static_cast<ElemType>(0));
+  }
+
+  if (temperatureRequested && !m_temperatureField)
+  {
+    m_temperatureField.emplace(static_cast<ElemType>(0));
+  }
+
+  if (machRequested || temperatureRequested)
+  {
+    frame.pMach        = machRequested ? &*m_machField : nullptr;
+    frame.pTemperature = temperatureRequested ? &*m_temperatureField : nullptr;
+    detail::calculateDerivedFieldsWrapper<GpuGridT>(
+      getConstDevicePtr(m_currState),
+      machRequested ? getDevicePtr(*m_machField) : thrust::device_ptr<ElemType>{},
+      temperatureRequested ? getDevicePtr(*m_temperatureField) : thrust::device_ptr<ElemType>{});
+  }
+
+  cudaStreamSynchronize(nullptr);
+  pipeline(frame);
+}
+
 template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
 auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticIntegrateStep(
   ETimeDiscretizationOrder timeOrder,
@@ -389,89 +551,74 @@ auto GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::staticInteg
   CudaFloat2T<ElemType> lambdas) -> ElemType
 {
   thrust::swap(m_prevState.values(), m_currState.values());
+
+  const auto pPrevState  = getDevicePtr(m_prevState);
+  const auto pCurrState  = getDevicePtr(m_currState);
+  const auto pStageState = (m_fluxSweep == EFluxSweep::eDimensionallySplit) ? pCurrState : m_stageState.data();
   switch (timeOrder)
   {
   case ETimeDiscretizationOrder::eOne:
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_prevState),
-      {},
-      getDevicePtr(m_currState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(1.0));
+    integrateSubStep(pPrevState, {}, pCurrState, dt, lambdas, static_cast<ElemType>(1.0));
     break;
 
   case ETimeDiscretizationOrder::eTwo:
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_prevState),
-      {},
-      getDevicePtr(m_firstState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(1.0));
-
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_firstState),
-      getDevicePtr(m_prevState),
-      getDevicePtr(m_currState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(0.5));
+    integrateSubStep(pPrevState, {}, pStageState, dt, lambdas, static_cast<ElemType>(1.0));
+    integrateSubStep(pStageState, pPrevState, pCurrState, dt, lambdas, static_cast<ElemType>(0.5));
     break;
   case ETimeDiscretizationOrder::eThree:
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_prevState),
-      {},
-      getDevicePtr(m_firstState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(1.0));
-
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_firstState),
-      getDevicePtr(m_prevState),
-      getDevicePtr(m_secondState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(0.25));
-
-    detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
-      getDevicePtr(m_secondState),
-      getDevicePtr(m_prevState),
-      getDevicePtr(m_currState),
-      getDevicePtr(currPhi()),
-      m_closestIndicesMap.data(),
-      getDevicePtr(m_boundaryConditions),
-      getDevicePtr(m_normals),
-      getDevicePtr(m_surfacePoints),
-      getDevicePtr(m_indexMatrices),
-      static_cast<unsigned>(m_closestIndicesMap.size()), dt, lambdas, static_cast<ElemType>(2.0 / 3.0));
+    integrateSubStep(pPrevState, {}, pCurrState, dt, lambdas, static_cast<ElemType>(1.0));
+    integrateSubStep(pCurrState, pPrevState, pStageState, dt, lambdas, static_cast<ElemType>(0.25));
+    integrateSubStep(pStageState, pPrevState, pCurrState, dt, lambdas, static_cast<ElemType>(2.0 / 3.0));
     break;
   default:
     break;
   }
 
+  writeIfNotValid(timeOrder, dt, lambdas);
+
+  m_time += dt;
+  if (m_pProbeRecorder)
+  {
+    m_pProbeRecorder->record(m_currState, m_cellClasses, m_time);
+  }
+
   return dt;
 }
 
+template <class GpuGridT, class ShapeT, class GasStateT, class PhysicalPropertiesT>
+void GpuSrmSolver<GpuGridT, ShapeT, GasStateT, PhysicalPropertiesT>::integrateSubStep(
+  thrust::device_ptr<GasStateType>       pPrevValue,
+  thrust::device_ptr<const GasStateType> pFirstValue,
+  thrust::device_ptr<GasStateType>       pCurrValue,
+  ElemType                               dt,
+  CudaFloat2T<ElemType>                  lambdas,
+  ElemType                               prevWeight)
+{
+  const auto subStepIndex = m_subStepCount++;
+  detail::srmIntegrateTVDSubStepWrapper<GpuGridT, ShapeT, PhysicalPropertiesT, order, GasStateT>(
+    pPrevValue,
+    pFirstValue,
+    pCurrValue,
+    getDevicePtr(m_cellClasses),
+    getDevicePtr(m_geometryPlanes.rReciprocals()),
+    m_calculateBlocks.data(),
+    m_activeTiles.data(),
+    m_activeTiles.size(),
+    m_closestIndicesMap.data(),
+    getDevicePtr(m_normals),
+    m_surfacePoints.data(),
+    m_indexMatrices.data(),
+    m_pseudoInverses.data(),
+    getDevicePtr(m_massFlowPressures),
+    m_massFlowCounters.data(),
+    m_ghostPartitionOffsets,
+    m_fluxSweep,
+    m_transposedState.data(),
+    m_xFluxes.data(),
+    m_yFluxes.data(),
+    m_invalidTiles.flags(subStepIndex),
+    subStepIndex,
+    dt, lambdas, prevWeight);
+}
+
 } // namespace 
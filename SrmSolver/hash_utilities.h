@@ -0,0 +1,25 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+inline std::uint64_t getFnv1aHash(const void * pData, std::size_t bytes)
+{
+  const auto pBytes = static_cast<const std::uint8_t *>(pData);
+  std::uint64_t hash{ 0xCBF29CE484222325ULL };
+  for (std::size_t idx{ 0U }; idx < bytes; ++idx)
+  {
+    hash ^= pBytes[idx];
+    hash *= 0x100000001B3ULL;
+  }
+
+  return hash;
+}
+
+inline std::uint64_t getFnv1aHash(const std::string & value)
+{
+  return getFnv1aHash(value.data(), value.size());
+}
+
+} // namespace kae
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "matrix_layout.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class GpuGridT, class LayoutT, class CallableT>
+void forEachCell(CallableT && callable)
+{
+  for (unsigned tileJ{ 0U }; tileJ < LayoutT::tileCountY; ++tileJ)
+  {
+    for (unsigned tileI{ 0U }; tileI < LayoutT::tileCountX; ++tileI)
+    {
+      const unsigned jEnd = std::min((tileJ + 1U) * LayoutT::tileSizeY, GpuGridT::ny);
+      const unsigned iEnd = std::min((tileI + 1U) * LayoutT::tileSizeX, GpuGridT::nx);
+      for (unsigned j{ tileJ * LayoutT::tileSizeY }; j < jEnd; ++j)
+      {
+        for (unsigned i{ tileI * LayoutT::tileSizeX }; i < iEnd; ++i)
+        {
+          callable(i, j);
+        }
+      }
+    }
+  }
+}
+
+template <class GpuGridT, class LayoutT, class ElemT>
+std::vector<ElemT> toLayout(const std::vector<ElemT> & rowMajorValues)
+{
+  std::vector<ElemT> values(LayoutT::size);
+  forEachCell<GpuGridT, LayoutT>([&](unsigned i, unsigned j)
+  {
+    values[LayoutT::getIndex(i, j)] = rowMajorValues[j * GpuGridT::nx + i];
+  });
+
+  return values;
+}
+
+template <class GpuGridT, class LayoutT, class ElemT>
+std::vector<ElemT> fromLayout(const std::vector<ElemT> & values)
+{
+  std::vector<ElemT> rowMajorValues(GpuGridT::n);
+  forEachCell<GpuGridT, LayoutT>([&](unsigned i, unsigned j)
+  {
+    rowMajorValues[j * GpuGridT::nx + i] = values[LayoutT::getIndex(i, j)];
+  });
+
+  return rowMajorValues;
+}
+
+template <class GpuGridT, class LayoutT, class ElemT>
+void calculateGradientNorms(const ElemT * pPhi, ElemT * pGradientNorms)
+{
+  constexpr unsigned halo{ 3U };
+  forEachCell<GpuGridT, LayoutT>([&](unsigned i, unsigned j)
+  {
+    if ((i < halo) || (j < halo) || (i >= GpuGridT::nx - halo) || (j >= GpuGridT::ny - halo))
+    {
+      return;
+    }
+
+    const auto at = [pPhi, i, j](int di, int dj) { return pPhi[LayoutT::getIndex(i + di, j + dj)]; };
+    const ElemT dx = (45 * (at(1, 0) - at(-1, 0)) - 9 * (at(2, 0) - at(-2, 0)) + (at(3, 0) - at(-3, 0))) /
+                     (60 * GpuGridT::hx);
+    const ElemT dy = (45 * (at(0, 1) - at(0, -1)) - 9 * (at(0, 2) - at(0, -2)) + (at(0, 3) - at(0, -3))) /
+                     (60 * GpuGridT::hy);
+    pGradientNorms[LayoutT::getIndex(i, j)] = std::hypot(dx, dy);
+  });
+}
+
+template <class GpuGridT, class LayoutT, class ElemT>
+void calculateClosestIndices(const ElemT * pPhi, unsigned * pClosestIndices)
+{
+  constexpr int halo{ 3 };
+  forEachCell<GpuGridT, LayoutT>([&](unsigned i, unsigned j)
+  {
+    if ((i < halo) || (j < halo) || (i >= GpuGridT::nx - halo) || (j >= GpuGridT::ny - halo))
+    {
+      return;
+    }
+
+    unsigned closestIdx = LayoutT::getIndex(i, j);
+    ElemT minDistance = std::numeric_limits<ElemT>::max();
+    for (int dj{ -halo }; dj <= halo; ++dj)
+    {
+      for (int di{ -halo }; di <= halo; ++di)
+      {
+        const unsigned idx = LayoutT::getIndex(i + di, j + dj);
+        const ElemT distance = std::fabs(pPhi[idx]);
+        if (pPhi[idx] < 0 && distance < minDistance)
+        {
+          minDistance = distance;
+          closestIdx = idx;
+        }
+      }
+    }
+
+    pClosestIndices[LayoutT::getIndex(i, j)] = closestIdx;
+  });
+}
+
+} // namespace detail
+
+} // namespace kae
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+template <class ElemT>
+using IntegralData = std::tuple<ElemT, ElemT, ElemT, ElemT, ElemT, ElemT, ElemT>;
+
+template <class ElemT>
+void writeIntegralData(std::ostream & stream, const std::vector<IntegralData<ElemT>> & values)
+{
+  stream << "t;P_av;P_max;S;Thrust;specThrust;velocity\n";
+  for (const auto & elem : values)
+  {
+    stream << std::get<0U>(elem) << ';' << std::get<1U>(elem) << ';'
+           << std::get<2U>(elem) << ';' << std::get<3U>(elem) << ';'
+           << std::get<4U>(elem) << ';' << std::get<5U>(elem) << ';'
+           << std::get<6U>(elem) << '\n';
+  }
+}
+
+} // namespace kae
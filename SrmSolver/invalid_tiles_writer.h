@@ -0,0 +1,55 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "gas_state.h"
+#include "gpu_matrix.h"
+
+namespace kae {
+
+// Writes the listed tiles plus the stencil halo around them, copying only the rows that are written.
+template <class GpuGridT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
+void writeInvalidTiles(std::ostream &                          stream,
+                       const std::vector<unsigned> &           tiles,
+                       const GpuMatrix<GpuGridT, GasStateT> &  prevState,
+                       const GpuMatrix<GpuGridT, GasStateT> &  currState,
+                       const GpuMatrix<GpuGridT, ElemT> &      phi)
+{
+  constexpr unsigned halo{ GpuGridT::smExtension };
+
+  stream << "# i;j;x;y;phi;prev rho;prev ux;prev uy;prev p;rho;ux;uy;p\n";
+  for (const auto tile : tiles)
+  {
+    const unsigned tileX  = tile % GpuGridT::gridSize.x;
+    const unsigned tileY  = tile / GpuGridT::gridSize.x;
+    const unsigned iBegin = tileX * GpuGridT::blockSize.x - std::min(tileX * GpuGridT::blockSize.x, halo);
+    const unsigned jBegin = tileY * GpuGridT::blockSize.y - std::min(tileY * GpuGridT::blockSize.y, halo);
+    const unsigned iEnd   = std::min((tileX + 1U) * GpuGridT::blockSize.x + halo, GpuGridT::nx);
+    const unsigned jEnd   = std::min((tileY + 1U) * GpuGridT::blockSize.y + halo, GpuGridT::ny);
+    const unsigned width  = iEnd - iBegin;
+
+    std::vector<GasStateT> prevRow(width);
+    std::vector<GasStateT> currRow(width);
+    std::vector<ElemT> phiRow(width);
+
+    stream << "# tile " << tileX << ' ' << tileY << '\n';
+    for (unsigned j{ jBegin }; j < jEnd; ++j)
+    {
+      const unsigned rowBegin = j * GpuGridT::nx + iBegin;
+      thrust::copy_n(std::begin(prevState.values()) + rowBegin, width, std::begin(prevRow));
+      thrust::copy_n(std::begin(currState.values()) + rowBegin, width, std::begin(currRow));
+      thrust::copy_n(std::begin(phi.values()) + rowBegin, width, std::begin(phiRow));
+
+      for (unsigned i{ iBegin }; i < iEnd; ++i)
+      {
+        const auto & prev = prevRow[i - iBegin];
+        const auto & curr = currRow[i - iBegin];
+        stream << i << ';' << j << ';' << i * GpuGridT::hx << ';' << j * GpuGridT::hy << ';' << phiRow[i - iBegin] << ';'
+               << prev.rho << ';' << prev.ux << ';' << prev.uy << ';' << prev.p << ';'
+               << curr.rho << ';' << curr.ux << ';' << curr.uy << ';' << curr.p << '\n';
+      }
+    }
+  }
+}
+
+} // namespace kae
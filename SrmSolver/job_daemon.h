@@ -0,0 +1,48 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "job_spool.h"
+#include "warm_solver_pool.h"
+
+namespace kae {
+
+// Long-lived runner for spooled jobs. Each ShapeSolverTypes argument is a shape and precision built into the
+// daemon; runs asking for anything else fail with a note in the spool. Identical runs are computed once and
+// served from the result cache afterwards.
+template <class... ShapeSolverTypesT>
+class JobDaemon
+{
+public:
+
+  JobDaemon(const std::wstring & spoolDirectory, unsigned coreBudget,
+            std::chrono::milliseconds pollInterval = std::chrono::milliseconds{ 200 });
+
+  // Blocks until a stop file appears in the spool directory and the running jobs are finished.
+  void run();
+
+  std::uint64_t computedCount() const { return m_computedCount; }
+  std::uint64_t cachedCount() const { return m_cachedCount; }
+
+private:
+
+  void workerLoop();
+  void process(const SpoolJob & job);
+  std::wstring produce(const RunDescription & run);
+  void compute(const RunDescription & run, const std::wstring & resultDirectory);
+
+private:
+
+  JobSpool                                          m_spool;
+  unsigned                                          m_coreBudget;
+  std::chrono::milliseconds                         m_pollInterval;
+  std::tuple<WarmSolverPool<ShapeSolverTypesT>...>  m_pools;
+  std::mutex                                        m_inFlightMutex;
+  std::map<std::uint64_t, std::shared_future<void>> m_inFlight;
+  std::atomic<std::uint64_t>                        m_computedCount{ 0U };
+  std::atomic<std::uint64_t>                        m_cachedCount{ 0U };
+};
+
+} // namespace kae
+
+#include "job_daemon_def.h"
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include <filesystem>
+
+#include "gpu_matrix_writer.h"
+#include "integral_data.h"
+#include "solver_callbacks.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class ShapeSolverTypesT>
+void runSpooledJob(const RunDescription &              run,
+                   WarmSolverPool<ShapeSolverTypesT> & pool,
+                   const std::wstring &                resultDirectory)
+{
+  namespace fs = std::filesystem;
+
+  using GpuGridType            = typename ShapeSolverTypesT::GpuGridType;
+  using PhysicalPropertiesType = typename ShapeSolverTypesT::PhysicalPropertiesType;
+  using ElemType               = typename GpuGridType::ElemType;
+
+  const auto deltaT = (run.deltaT > 0.0) ?
+    static_cast<ElemType>(run.deltaT) :
+    GpuGridType::hx / 2 / BurningRate<PhysicalPropertiesType>::get(static_cast<ElemType>(1));
+
+  auto pSolver = pool.acquire(run);
+  CollectIntegralsCallback<ElemType> callback;
+  try
+  {
+    switch (run.mode)
+    {
+    case EIntegrationMode::eStatic:
+      pSolver->staticIntegrate(run.iterationCount, run.timeOrder, callback);
+      break;
+    case EIntegrationMode::eDynamic:
+      pSolver->dynamicIntegrate(run.iterationCount, deltaT, run.timeOrder, callback);
+      break;
+    case EIntegrationMode::eLaggedDynamic:
+      pSolver->laggedDynamicIntegrate(run.iterationCount, deltaT, run.timeOrder, callback);
+      break;
+    case EIntegrationMode::eQuasiStationary:
+      pSolver->quasiStationaryDynamicIntegrate(run.iterationCount, deltaT, run.timeOrder, callback);
+      break;
+    default:
+      break;
+    }
+  }
+  catch (...)
+  {
+    pool.release(run, std::move(pSolver));
+    throw;
+  }
+
+  const fs::path folder{ resultDirectory };
+  if (run.writeIntegrals)
+  {
+    std::ofstream integralsFile{ folder / L"mean_pressure_values.dat" };
+    writeIntegralData(integralsFile, callback.values());
+  }
+
+  // Static runs report no integrals through the callback, so their final fields are the result.
+  if (run.writeFields || (run.mode == EIntegrationMode::eStatic))
+  {
+    writeMatrixToFile(pSolver->currPhi(), (folder / L"sgd.dat").string());
+    writeMatrixToFile(pSolver->currState(), (folder / L"p.dat").string(), (folder / L"ux.dat").string(),
+                      (folder / L"uy.dat").string(), (folder / L"mach.dat").string(), (folder / L"T.dat").string());
+  }
+
+  std::ofstream runFile{ folder / L"run.txt" };
+  runFile << run.serialize();
+  pool.release(run, std::move(pSolver));
+}
+
+} // namespace detail
+
+template <class... ShapeSolverTypesT>
+JobDaemon<ShapeSolverTypesT...>::JobDaemon(const std::wstring &      spoolDirectory,
+                                           unsigned                  coreBudget,
+                                           std::chrono::milliseconds pollInterval)
+  : m_spool{ spoolDirectory },
+    m_coreBudget{ std::max(coreBudget, 1U) },
+    m_pollInterval{ pollInterval }
+{
+}
+
+template <class... ShapeSolverTypesT>
+void JobDaemon<ShapeSolverTypesT...>::run()
+{
+  m_spool.clearStopRequest();
+  m_spool.requeueInterrupted();
+
+  std::vector<std::thread> workers;
+  for (unsigned workerIdx{ 0U }; workerIdx < m_coreBudget; ++workerIdx)
+  {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+
+  for (auto & worker : workers)
+  {
+    worker.join();
+  }
+
+  m_spool.clearStopRequest();
+}
+
+template <class... ShapeSolverTypesT>
+void JobDaemon<ShapeSolverTypesT...>::workerLoop()
+{
+  while (!m_spool.stopRequested())
+  {
+    const auto job = m_spool.claim();
+    if (!job)
+    {
+      std::this_thread::sleep_for(m_pollInterval);
+      continue;
+    }
+
+    process(*job);
+  }
+}
+
+template <class... ShapeSolverTypesT>
+void JobDaemon<ShapeSolverTypesT...>::process(const SpoolJob & job)
+{
+  namespace fs = std::filesystem;
+
+  try
+  {
+    const auto resultDirectory = produce(job.run);
+    if (!job.run.outputDirectory.empty())
+    {
+      fs::create_directories(job.run.outputDirectory);
+      fs::copy(resultDirectory, job.run.outputDirectory,
+               fs::copy_options::recursive | fs::copy_options::overwrite_existing);
+    }
+
+    m_spool.complete(job, resultDirectory);
+  }
+  catch (const std::exception & e)
+  {
+    m_spool.fail(job, e.what());
+  }
+}
+
+template <class... ShapeSolverTypesT>
+std::wstring JobDaemon<ShapeSolverTypesT...>::produce(const RunDescription & run)
+{
+  namespace fs = std::filesystem;
+
+  const auto hash            = run.hash();
+  const auto resultDirectory = m_spool.getResultDirectory(hash);
+
+  std::promise<void>       promise;
+  std::shared_future<void> inFlight;
+  {
+    std::lock_guard<std::mutex> lock{ m_inFlightMutex };
+    if (fs::exists(resultDirectory))
+    {
+      ++m_cachedCount;
+      return resultDirectory;
+    }
+
+    const auto it = m_inFlight.find(hash);
+    if (it != std::end(m_inFlight))
+    {
+      inFlight = it->second;
+    }
+    else
+    {
+      m_inFlight.emplace(hash, promise.get_future().share());
+    }
+  }
+
+  if (inFlight.valid())
+  {
+    inFlight.get();
+    ++m_cachedCount;
+    return resultDirectory;
+  }
+
+  try
+  {
+    const auto temporaryDirectory = m_spool.getTemporaryDirectory(hash);
+    fs::remove_all(temporaryDirectory);
+    fs::create_directories(temporaryDirectory);
+    compute(run, temporaryDirectory);
+
+    // Another daemon on the same spool may have published the same result meanwhile, either copy will do.
+    std::error_code errorCode;
+    fs::rename(temporaryDirectory, resultDirectory, errorCode);
+    if (errorCode)
+    {
+      fs::remove_all(temporaryDirectory, errorCode);
+      if (!fs::exists(resultDirectory))
+      {
+        throw std::runtime_error("Unable to publish run result");
+      }
+    }
+  }
+  catch (...)
+  {
+    promise.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> lock{ m_inFlightMutex };
+    m_inFlight.erase(hash);
+    throw;
+  }
+
+  ++m_computedCount;
+  promise.set_value();
+  std::lock_guard<std::mutex> lock{ m_inFlightMutex };
+  m_inFlight.erase(hash);
+  return resultDirectory;
+}
+
+template <class... ShapeSolverTypesT>
+void JobDaemon<ShapeSolverTypesT...>::compute(const RunDescription & run, const std::wstring & resultDirectory)
+{
+  bool isDispatched{ false };
+  const auto tryRun = [&run, &resultDirectory, &isDispatched](auto & pool)
+  {
+    using PoolType = std::decay_t<decltype(pool)>;
+    if (!isDispatched && PoolType::matches(run))
+    {
+      isDispatched = true;
+      detail::runSpooledJob(run, pool, resultDirectory);
+    }
+  };
+  std::apply([&tryRun](auto &... pools) { (tryRun(pools), ...); }, m_pools);
+
+  if (!isDispatched)
+  {
+    throw std::invalid_argument("Shape and precision of the run are not built into this daemon");
+  }
+}
+
+} // namespace kae
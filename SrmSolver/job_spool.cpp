@@ -0,0 +1,137 @@
+
+#include "job_spool.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace kae {
+
+namespace {
+
+constexpr wchar_t incomingFolder[] = L"incoming";
+constexpr wchar_t runningFolder[]  = L"running";
+constexpr wchar_t doneFolder[]     = L"done";
+constexpr wchar_t failedFolder[]   = L"failed";
+constexpr wchar_t resultsFolder[]  = L"results";
+constexpr wchar_t stopFile[]       = L"stop";
+constexpr wchar_t runExtension[]   = L".run";
+
+} // namespace
+
+JobSpool::JobSpool(const std::wstring & directory)
+  : m_directory{ directory }
+{
+  for (const auto folder : { incomingFolder, runningFolder, doneFolder, failedFolder, resultsFolder })
+  {
+    fs::create_directories(fs::path{ m_directory } / folder);
+  }
+}
+
+std::optional<SpoolJob> JobSpool::claim()
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  std::vector<fs::path> candidates;
+  std::error_code errorCode;
+  for (const auto & entry : fs::directory_iterator{ fs::path{ m_directory } / incomingFolder, errorCode })
+  {
+    if (entry.is_regular_file() && (entry.path().extension() == runExtension))
+    {
+      candidates.push_back(entry.path());
+    }
+  }
+
+  std::sort(std::begin(candidates), std::end(candidates));
+  for (const auto & candidate : candidates)
+  {
+    const auto runningPath = fs::path{ m_directory } / runningFolder / candidate.filename();
+    fs::rename(candidate, runningPath, errorCode);
+    if (errorCode)
+    {
+      continue;
+    }
+
+    SpoolJob job{ candidate.stem().wstring(), runningPath.wstring(), {} };
+    try
+    {
+      std::ifstream file{ runningPath };
+      job.run = parseRunDescription(file);
+    }
+    catch (const std::exception & e)
+    {
+      finish(job, failedFolder, L".error", e.what());
+      continue;
+    }
+
+    return job;
+  }
+
+  return std::nullopt;
+}
+
+void JobSpool::complete(const SpoolJob & job, const std::wstring & resultDirectory)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  finish(job, doneFolder, L".result", fs::path{ resultDirectory }.u8string());
+}
+
+void JobSpool::fail(const SpoolJob & job, const std::string & message)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  finish(job, failedFolder, L".error", message);
+}
+
+void JobSpool::finish(const SpoolJob & job, const std::wstring & folder, const std::wstring & noteExtension,
+                      const std::string & note)
+{
+  const auto targetFolder = fs::path{ m_directory } / folder;
+  std::error_code errorCode;
+  fs::rename(job.path, targetFolder / (job.name + runExtension), errorCode);
+
+  std::ofstream noteFile{ targetFolder / (job.name + noteExtension) };
+  noteFile << note << '\n';
+}
+
+std::size_t JobSpool::requeueInterrupted()
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  std::size_t requeuedCount{ 0U };
+  std::error_code errorCode;
+  for (const auto & entry : fs::directory_iterator{ fs::path{ m_directory } / runningFolder, errorCode })
+  {
+    fs::rename(entry.path(), fs::path{ m_directory } / incomingFolder / entry.path().filename(), errorCode);
+    requeuedCount += errorCode ? 0U : 1U;
+  }
+
+  return requeuedCount;
+}
+
+bool JobSpool::stopRequested() const
+{
+  std::error_code errorCode;
+  return fs::exists(fs::path{ m_directory } / stopFile, errorCode);
+}
+
+void JobSpool::clearStopRequest()
+{
+  std::error_code errorCode;
+  fs::remove(fs::path{ m_directory } / stopFile, errorCode);
+}
+
+std::wstring JobSpool::getResultDirectory(std::uint64_t hash) const
+{
+  return (fs::path{ m_directory } / resultsFolder / fs::u8path(toHexString(hash))).wstring();
+}
+
+std::wstring JobSpool::getTemporaryDirectory(std::uint64_t hash) const
+{
+  const auto threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return (fs::path{ m_directory } / resultsFolder /
+          fs::u8path(toHexString(hash) + ".tmp" + toHexString(threadId))).wstring();
+}
+
+} // namespace kae
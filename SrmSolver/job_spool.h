@@ -0,0 +1,54 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "run_description.h"
+
+namespace kae {
+
+struct SpoolJob
+{
+  std::wstring   name;
+  std::wstring   path;
+  RunDescription run;
+};
+
+// Spool directory layout:
+//   incoming/*.run   - run descriptions dropped by clients (write elsewhere and rename in)
+//   running/         - jobs claimed by a worker
+//   done/, failed/   - finished descriptions with a .result or .error note next to them
+//   results/<hash>/  - result cache keyed by RunDescription::hash()
+//   stop             - asks the daemon to finish the running jobs and exit
+class JobSpool
+{
+public:
+
+  explicit JobSpool(const std::wstring & directory);
+
+  std::optional<SpoolJob> claim();
+  void complete(const SpoolJob & job, const std::wstring & resultDirectory);
+  void fail(const SpoolJob & job, const std::string & message);
+
+  // Moves jobs left in running/ by a previous daemon back to incoming/.
+  std::size_t requeueInterrupted();
+
+  bool stopRequested() const;
+  void clearStopRequest();
+
+  std::wstring getResultDirectory(std::uint64_t hash) const;
+  std::wstring getTemporaryDirectory(std::uint64_t hash) const;
+
+  const std::wstring & directory() const { return m_directory; }
+
+private:
+
+  void finish(const SpoolJob & job, const std::wstring & folder, const std::wstring & noteExtension,
+              const std::string & note);
+
+private:
+
+  std::wstring m_directory;
+  std::mutex   m_mutex;
+};
+
+} // namespace kae
@@ -0,0 +1,210 @@
+
+#include "live_view_ring.h"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <filesystem>
+#endif
+
+namespace kae {
+
+namespace {
+
+std::size_t getSlotBytes(std::uint32_t maxValueCount)
+{
+  const std::size_t slotBytes = sizeof(LiveViewFrameHeader) + maxValueCount * sizeof(float);
+  constexpr std::size_t alignment{ alignof(LiveViewFrameHeader) };
+  return (slotBytes + alignment - 1U) / alignment * alignment;
+}
+
+} // namespace
+
+LiveViewRing::LiveViewRing(const std::wstring & path, std::uint32_t slotCount, std::uint32_t maxValueCount)
+  : m_slotCount{ slotCount },
+    m_maxValueCount{ maxValueCount },
+    m_mappedBytes{ sizeof(LiveViewRingHeader) + slotCount * getSlotBytes(maxValueCount) }
+{
+  if (slotCount == 0U)
+  {
+    throw std::invalid_argument("Live view ring must have at least one slot");
+  }
+
+#ifdef _WIN32
+  const HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                        nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error("Unable to create live view file");
+  }
+
+  const auto mappedBytes = static_cast<std::uint64_t>(m_mappedBytes);
+  const HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READWRITE,
+                                                  static_cast<DWORD>(mappedBytes >> 32U),
+                                                  static_cast<DWORD>(mappedBytes & 0xFFFFFFFFU), nullptr);
+  if (mappingHandle == nullptr)
+  {
+    CloseHandle(fileHandle);
+    throw std::runtime_error("Unable to map live view file");
+  }
+
+  m_pMapped = MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0U, 0U, m_mappedBytes);
+  m_fileHandle = reinterpret_cast<std::intptr_t>(fileHandle);
+  m_mappingHandle = reinterpret_cast<std::intptr_t>(mappingHandle);
+#else
+  const int fileHandle = open(std::filesystem::path{ path }.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fileHandle < 0)
+  {
+    throw std::runtime_error("Unable to create live view file");
+  }
+
+  if (ftruncate(fileHandle, static_cast<off_t>(m_mappedBytes)) != 0)
+  {
+    close(fileHandle);
+    throw std::runtime_error("Unable to resize live view file");
+  }
+
+  void * pMapped = mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileHandle, 0);
+  m_pMapped = (pMapped == MAP_FAILED) ? nullptr : pMapped;
+  m_fileHandle = fileHandle;
+#endif
+
+  if (m_pMapped == nullptr)
+  {
+    release();
+    throw std::runtime_error("Unable to map live view file");
+  }
+
+  std::memset(m_pMapped, 0, m_mappedBytes);
+  m_pHeader = new (m_pMapped) LiveViewRingHeader{};
+  m_pHeader->magic     = LiveViewRingHeader::magicValue;
+  m_pHeader->version   = LiveViewRingHeader::versionValue;
+  m_pHeader->slotCount = slotCount;
+  m_pHeader->slotBytes = static_cast<std::uint32_t>(getSlotBytes(maxValueCount));
+  for (std::uint32_t slotIdx{ 0U }; slotIdx < slotCount; ++slotIdx)
+  {
+    new (getFrame(slotIdx)) LiveViewFrameHeader{};
+  }
+}
+
+LiveViewRing::~LiveViewRing()
+{
+  release();
+}
+
+void LiveViewRing::release()
+{
+#ifdef _WIN32
+  if (m_pMapped != nullptr)
+  {
+    UnmapViewOfFile(m_pMapped);
+  }
+
+  if (m_mappingHandle != -1)
+  {
+    CloseHandle(reinterpret_cast<HANDLE>(m_mappingHandle));
+  }
+
+  if (m_fileHandle != -1)
+  {
+    CloseHandle(reinterpret_cast<HANDLE>(m_fileHandle));
+  }
+#else
+  if (m_pMapped != nullptr)
+  {
+    munmap(m_pMapped, m_mappedBytes);
+  }
+
+  if (m_fileHandle != -1)
+  {
+    close(static_cast<int>(m_fileHandle));
+  }
+#endif
+
+  m_pMapped       = nullptr;
+  m_mappingHandle = -1;
+  m_fileHandle    = -1;
+}
+
+bool LiveViewRing::publish(ELiveViewFrameKind kind,
+                           std::uint32_t      iteration,
+                           double             t,
+                           std::uint32_t      width,
+                           std::uint32_t      height,
+                           const float *      pValues)
+{
+  const std::uint64_t valueCount = static_cast<std::uint64_t>(width) * height;
+  if (valueCount > m_maxValueCount)
+  {
+    return false;
+  }
+
+  const std::uint64_t frameIdx = m_pHeader->publishedCount.load(std::memory_order_relaxed);
+  LiveViewFrameHeader * pFrame = getFrame(frameIdx);
+
+  pFrame->sequence.store(2U * frameIdx + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  pFrame->kind       = kind;
+  pFrame->iteration  = iteration;
+  pFrame->t          = t;
+  pFrame->width      = width;
+  pFrame->height     = height;
+  pFrame->valueCount = static_cast<std::uint32_t>(valueCount);
+  std::memcpy(reinterpret_cast<char *>(pFrame) + sizeof(LiveViewFrameHeader), pValues, valueCount * sizeof(float));
+
+  pFrame->sequence.store(2U * frameIdx + 2U, std::memory_order_release);
+  m_pHeader->publishedCount.store(frameIdx + 1U, std::memory_order_release);
+  return true;
+}
+
+bool LiveViewRing::tryRead(std::uint64_t frameIdx, LiveViewFrameHeader & header, std::vector<float> & values) const
+{
+  const std::uint64_t publishedSequence = 2U * frameIdx + 2U;
+  const LiveViewFrameHeader * pFrame = getFrame(frameIdx);
+  if (pFrame->sequence.load(std::memory_order_acquire) != publishedSequence)
+  {
+    return false;
+  }
+
+  header.kind       = pFrame->kind;
+  header.iteration  = pFrame->iteration;
+  header.t          = pFrame->t;
+  header.width      = pFrame->width;
+  header.height     = pFrame->height;
+  header.valueCount = std::min(pFrame->valueCount, m_maxValueCount);
+  values.resize(header.valueCount);
+  std::memcpy(values.data(), reinterpret_cast<const char *>(pFrame) + sizeof(LiveViewFrameHeader),
+              header.valueCount * sizeof(float));
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (pFrame->sequence.load(std::memory_order_relaxed) != publishedSequence)
+  {
+    return false;
+  }
+
+  header.sequence.store(publishedSequence, std::memory_order_relaxed);
+  return true;
+}
+
+std::uint64_t LiveViewRing::publishedCount() const
+{
+  return m_pHeader->publishedCount.load(std::memory_order_acquire);
+}
+
+LiveViewFrameHeader * LiveViewRing::getFrame(std::uint64_t frameIdx) const
+{
+  const auto slotIdx = static_cast<std::size_t>(frameIdx % m_slotCount);
+  auto * pFirstSlot = static_cast<char *>(m_pMapped) + sizeof(LiveViewRingHeader);
+  return reinterpret_cast<LiveViewFrameHeader *>(pFirstSlot + slotIdx * getSlotBytes(m_maxValueCount));
+}
+
+} // namespace kae
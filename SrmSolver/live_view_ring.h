@@ -0,0 +1,73 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+enum class ELiveViewFrameKind : std::uint32_t { eField, eIntegrals };
+
+struct LiveViewRingHeader
+{
+  constexpr static std::uint32_t magicValue{ 0x4B41454CU };
+  constexpr static std::uint32_t versionValue{ 1U };
+
+  std::uint32_t              magic;
+  std::uint32_t              version;
+  std::uint32_t              slotCount;
+  std::uint32_t              slotBytes;
+  std::atomic<std::uint64_t> publishedCount;
+};
+
+struct LiveViewFrameHeader
+{
+  std::atomic<std::uint64_t> sequence;
+  ELiveViewFrameKind         kind;
+  std::uint32_t              iteration;
+  double                     t;
+  std::uint32_t              width;
+  std::uint32_t              height;
+  std::uint32_t              valueCount;
+  std::uint32_t              reserved;
+};
+
+class LiveViewRing
+{
+public:
+
+  LiveViewRing(const std::wstring & path, std::uint32_t slotCount, std::uint32_t maxValueCount);
+  ~LiveViewRing();
+
+  LiveViewRing(const LiveViewRing &) = delete;
+  LiveViewRing & operator=(const LiveViewRing &) = delete;
+
+  bool publish(ELiveViewFrameKind kind,
+               std::uint32_t      iteration,
+               double             t,
+               std::uint32_t      width,
+               std::uint32_t      height,
+               const float *      pValues);
+
+  // Reader side of the slot protocol. Fails if the frame hasn't been published yet, was overwritten by a later
+  // frame or was being written while it was copied.
+  bool tryRead(std::uint64_t frameIdx, LiveViewFrameHeader & header, std::vector<float> & values) const;
+
+  std::uint32_t maxValueCount() const { return m_maxValueCount; }
+  std::uint64_t publishedCount() const;
+
+private:
+
+  LiveViewFrameHeader * getFrame(std::uint64_t frameIdx) const;
+  void release();
+
+private:
+
+  std::uint32_t        m_slotCount;
+  std::uint32_t        m_maxValueCount;
+  std::size_t          m_mappedBytes;
+  void *               m_pMapped{ nullptr };
+  std::intptr_t        m_fileHandle{ -1 };
+  std::intptr_t        m_mappingHandle{ -1 };
+  LiveViewRingHeader * m_pHeader{ nullptr };
+};
+
+} // namespace kae
@@ -2,13 +2,31 @@
 #include <iostream>
 
 #include "filesystem.h"
+#include "job_daemon.h"
 #include "shape_solver_types.h"
 #include "solver_callbacks.h"
 
-int main()
+int runDaemon(const std::string & spoolDirectory, unsigned coreBudget)
+{
+  using DaemonType = kae::JobDaemon<kae::ShapeSolverTypes<kae::EShapeType::eNozzleLessShape,    float>,
+                                    kae::ShapeSolverTypes<kae::EShapeType::eWithUmbrellaShape,  float>,
+                                    kae::ShapeSolverTypes<kae::EShapeType::eFlushMountedNozzle, float>,
+                                    kae::ShapeSolverTypes<kae::EShapeType::eDualThrustShape,    float>>;
+  DaemonType daemon{ std::filesystem::u8path(spoolDirectory).wstring(), coreBudget };
+  daemon.run();
+  std::cout << "Computed runs: " << daemon.computedCount() << ". Cached runs: " << daemon.cachedCount() << '\n';
+  return 0;
+}
+
+int main(int argc, char * argv[])
 {
   try
   {
+    if ((argc >= 3) && (std::string{ argv[1] } == "--daemon"))
+    {
+      return runDaemon(argv[2], (argc >= 4) ? static_cast<unsigned>(std::stoul(argv[3])) : 1U);
+    }
+
     using ElemType               = float;
     using ShapeSolverType        = kae::ShapeSolverTypes<kae::EShapeType::eWithUmbrellaShape, ElemType>;
     using GpuGridType            = ShapeSolverType::GpuGridType;
@@ -25,6 +43,11 @@ int main()
     std::cout << dt << '\n';
     SrmSolverType srmSolver{ {}, ShapeSolverType::initialGasState, 100U, static_cast<ElemType>(0.8) };
     srmSolver.dynamicIntegrate(2000U, dt, kae::ETimeDiscretizationOrder::eTwo, callback);
+
+    const auto stats = srmSolver.stats();
+    std::cout << "Mass flow inlet Newton iterations per solve: "
+              << static_cast<double>(stats.massFlowIterationCount) / std::max(stats.massFlowSolveCount, std::uint64_t{ 1U })
+              << '\n';
   }
   catch (const std::exception & e)
   {
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "cuda_includes.h"
+
+namespace kae {
+
+template <class GpuGridT>
+struct RowMajorLayout
+{
+  constexpr static unsigned tileSizeX{ GpuGridT::nx };
+  constexpr static unsigned tileSizeY{ 1U };
+  constexpr static unsigned tileCountX{ 1U };
+  constexpr static unsigned tileCountY{ GpuGridT::ny };
+  constexpr static unsigned size{ GpuGridT::n };
+
+  HOST_DEVICE static unsigned getIndex(unsigned i, unsigned j)
+  {
+    return j * GpuGridT::nx + i;
+  }
+};
+
+template <class GpuGridT, unsigned TileSizeX = 32U, unsigned TileSizeY = 8U>
+struct TiledLayout
+{
+  constexpr static unsigned tileSizeX{ TileSizeX };
+  constexpr static unsigned tileSizeY{ TileSizeY };
+  constexpr static unsigned tileSize{ tileSizeX * tileSizeY };
+  constexpr static unsigned tileCountX{ (GpuGridT::nx + tileSizeX - 1U) / tileSizeX };
+  constexpr static unsigned tileCountY{ (GpuGridT::ny + tileSizeY - 1U) / tileSizeY };
+  constexpr static unsigned size{ tileCountX * tileCountY * tileSize };
+
+  HOST_DEVICE static unsigned getIndex(unsigned i, unsigned j)
+  {
+    const unsigned tileIdx = (j / tileSizeY) * tileCountX + i / tileSizeX;
+    return tileIdx * tileSize + (j % tileSizeY) * tileSizeX + i % tileSizeX;
+  }
+};
+
+namespace detail {
+
+HOST_DEVICE inline unsigned spreadBits(unsigned value)
+{
+  value = (value | (value << 8U)) & 0x00FF00FFU;
+  value = (value | (value << 4U)) & 0x0F0F0F0FU;
+  value = (value | (value << 2U)) & 0x33333333U;
+  value = (value | (value << 1U)) & 0x55555555U;
+  return value;
+}
+
+} // namespace detail
+
+template <class GpuGridT, unsigned TileSize = 16U>
+struct MortonTiledLayout
+{
+  static_assert((TileSize & (TileSize - 1U)) == 0U, "Error! Morton tile size must be a power of two.");
+
+  constexpr static unsigned tileSizeX{ TileSize };
+  constexpr static unsigned tileSizeY{ TileSize };
+  constexpr static unsigned tileSize{ tileSizeX * tileSizeY };
+  constexpr static unsigned tileCountX{ (GpuGridT::nx + tileSizeX - 1U) / tileSizeX };
+  constexpr static unsigned tileCountY{ (GpuGridT::ny + tileSizeY - 1U) / tileSizeY };
+  constexpr static unsigned size{ tileCountX * tileCountY * tileSize };
+
+  HOST_DEVICE static unsigned getIndex(unsigned i, unsigned j)
+  {
+    const unsigned tileIdx = (j / tileSizeY) * tileCountX + i / tileSizeX;
+    const unsigned mortonIdx = detail::spreadBits(i % tileSizeX) | (detail::spreadBits(j % tileSizeY) << 1U);
+    return tileIdx * tileSize + mortonIdx;
+  }
+};
+
+} // namespace kae
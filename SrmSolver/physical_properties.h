@@ -3,6 +3,7 @@
 #include <gcem.hpp>
 
 #include "gas_state.h"
+#include "power_law.h"
 #include "to_float.h"
 
 namespace kae {
@@ -33,6 +34,8 @@ private:
 
 public:
 
+  using NuType = NuT;
+
   constexpr static ElemT kappa = kappaDim;
   constexpr static ElemT gammaComplex = gammaComplexDim;
   constexpr static ElemT nu    = nuDim;
@@ -57,7 +60,7 @@ struct BurningRate
   template <class ElemT, class = std::enable_if_t<std::is_floating_point<ElemT>::value>>
   HOST_DEVICE static ElemT get(ElemT p)
   {
-    return -PhysicalPropertiesT::mt * std::pow(p, PhysicalPropertiesT::nu) / PhysicalPropertiesT::rhoP;
+    return -PhysicalPropertiesT::mt * PowerLaw<typename PhysicalPropertiesT::NuType>::get(p) / PhysicalPropertiesT::rhoP;
   }
 };
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "std_includes.h"
+#include "cuda_includes.h"
+
+#include "to_float.h"
+
+namespace kae {
+
+namespace detail {
+
+HOST_DEVICE inline int floatAsInt(float value)
+{
+#ifdef __CUDA_ARCH__
+  return __float_as_int(value);
+#else
+  int result;
+  std::memcpy(&result, &value, sizeof(float));
+  return result;
+#endif
+}
+
+HOST_DEVICE inline float intAsFloat(int value)
+{
+#ifdef __CUDA_ARCH__
+  return __int_as_float(value);
+#else
+  float result;
+  std::memcpy(&result, &value, sizeof(float));
+  return result;
+#endif
+}
+
+HOST_DEVICE inline float fastLog2(float x)
+{
+  const int bits     = floatAsInt(x) - 0x3F3504F3;
+  const int exponent = bits >> 23;
+  const float u      = intAsFloat((bits & 0x007FFFFF) + 0x3F3504F3) - 1.0f;
+
+  float poly = 1.261484659e-01f;
+  poly = poly * u - 2.074210351e-01f;
+  poly = poly * u + 2.156698591e-01f;
+  poly = poly * u - 2.389203398e-01f;
+  poly = poly * u + 2.879183245e-01f;
+  poly = poly * u - 3.607048281e-01f;
+  poly = poly * u + 4.809106099e-01f;
+  poly = poly * u - 7.213473334e-01f;
+  poly = poly * u + 1.442695004e+00f;
+  return static_cast<float>(exponent) + u * poly;
+}
+
+HOST_DEVICE inline float fastExp2(float y)
+{
+  constexpr float roundingShift{ 12582912.0f };
+  const float shifted = y + roundingShift;
+  const int n         = floatAsInt(shifted) - floatAsInt(roundingShift);
+  const float f       = y - (shifted - roundingShift);
+
+  float poly = 1.533757684e-04f;
+  poly = poly * f + 1.339986036e-03f;
+  poly = poly * f + 9.618519534e-03f;
+  poly = poly * f + 5.550328998e-02f;
+  poly = poly * f + 2.402264661e-01f;
+  poly = poly * f + 6.931472056e-01f;
+  poly = poly * f + 1.000000001e+00f;
+  return poly * intAsFloat((n + 127) << 23);
+}
+
+template <class NuT>
+struct PowerLawImpl
+{
+  HOST_DEVICE static float get(float p)
+  {
+    return fastExp2(ToFloatV<NuT, float> * fastLog2(p));
+  }
+
+  HOST_DEVICE static float getReciprocal(float p)
+  {
+    return fastExp2(-ToFloatV<NuT, float> * fastLog2(p));
+  }
+
+  HOST_DEVICE static double get(double p)
+  {
+    return std::exp2(ToFloatV<NuT, double> * std::log2(p));
+  }
+
+  HOST_DEVICE static double getReciprocal(double p)
+  {
+    return std::exp2(-ToFloatV<NuT, double> * std::log2(p));
+  }
+};
+
+template <>
+struct PowerLawImpl<std::ratio<1, 2>>
+{
+  template <class ElemT>
+  HOST_DEVICE static ElemT get(ElemT p)
+  {
+    return std::sqrt(p);
+  }
+
+  template <class ElemT>
+  HOST_DEVICE static ElemT getReciprocal(ElemT p)
+  {
+    return 1 / std::sqrt(p);
+  }
+};
+
+} // namespace detail
+
+// Float results stay within 8 ulp of the correctly rounded p^nu for p in [2^-10, 2^10] and 0 < nu < 1.
+template <class NuT>
+using PowerLaw = detail::PowerLawImpl<typename NuT::type>;
+
+} // namespace kae
@@ -0,0 +1,228 @@
+
+#include "run_description.h"
+
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#include "hash_utilities.h"
+
+namespace kae {
+
+namespace {
+
+template <class EnumT, std::size_t N>
+const char * getName(EnumT value, const std::pair<EnumT, const char *> (&names)[N])
+{
+  for (const auto & elem : names)
+  {
+    if (elem.first == value)
+    {
+      return elem.second;
+    }
+  }
+
+  throw std::invalid_argument("Unknown enumeration value");
+}
+
+template <class EnumT, std::size_t N>
+EnumT getValue(const std::string & name, const std::pair<EnumT, const char *> (&names)[N])
+{
+  for (const auto & elem : names)
+  {
+    if (name == elem.second)
+    {
+      return elem.first;
+    }
+  }
+
+  throw std::invalid_argument("Unknown value \"" + name + "\"");
+}
+
+constexpr std::pair<EShapeType, const char *> shapeNames[] = {
+  { EShapeType::eNozzleLessShape,    "nozzleLess"         },
+  { EShapeType::eWithUmbrellaShape,  "withUmbrella"       },
+  { EShapeType::eFlushMountedNozzle, "flushMountedNozzle" },
+  { EShapeType::eDualThrustShape,    "dualThrust"         }
+};
+
+constexpr std::pair<EIntegrationMode, const char *> modeNames[] = {
+  { EIntegrationMode::eStatic,          "static"          },
+  { EIntegrationMode::eDynamic,         "dynamic"         },
+  { EIntegrationMode::eLaggedDynamic,   "laggedDynamic"   },
+  { EIntegrationMode::eQuasiStationary, "quasiStationary" }
+};
+
+constexpr std::pair<ETimeDiscretizationOrder, const char *> timeOrderNames[] = {
+  { ETimeDiscretizationOrder::eOne,   "1" },
+  { ETimeDiscretizationOrder::eTwo,   "2" },
+  { ETimeDiscretizationOrder::eThree, "3" }
+};
+
+constexpr std::pair<EFluxSweep, const char *> fluxSweepNames[] = {
+  { EFluxSweep::eFused,              "fused" },
+  { EFluxSweep::eDimensionallySplit, "split" }
+};
+
+std::string trim(const std::string & value)
+{
+  const auto first = value.find_first_not_of(" \t\r");
+  if (first == std::string::npos)
+  {
+    return {};
+  }
+
+  const auto last = value.find_last_not_of(" \t\r");
+  return value.substr(first, last - first + 1U);
+}
+
+template <class T>
+T parseNumber(const std::string & key, const std::string & value)
+{
+  std::istringstream stream{ value };
+  T result{};
+  if (!(stream >> result) || !stream.eof())
+  {
+    throw std::invalid_argument("Invalid number for \"" + key + "\": \"" + value + "\"");
+  }
+
+  return result;
+}
+
+bool parseBool(const std::string & key, const std::string & value)
+{
+  if ((value == "true") || (value == "1"))
+  {
+    return true;
+  }
+
+  if ((value == "false") || (value == "0"))
+  {
+    return false;
+  }
+
+  throw std::invalid_argument("Invalid flag for \"" + key + "\": \"" + value + "\"");
+}
+
+} // namespace
+
+std::string RunDescription::serialize() const
+{
+  std::ostringstream stream;
+  stream << "shape="          << getName(shape, shapeNames)                     << '\n'
+         << "precision="      << ((elemBytes == sizeof(double)) ? "double" : "float") << '\n'
+         << "mode="           << getName(mode, modeNames)                       << '\n'
+         << "iterations="     << iterationCount                                 << '\n'
+         << "reinitialize="   << reinitializeIterationCount                     << '\n'
+         << "courant="        << std::hexfloat << courant                       << '\n'
+         << "deltaT="         << deltaT << std::defaultfloat                    << '\n'
+         << "timeOrder="      << getName(timeOrder, timeOrderNames)             << '\n'
+         << "fluxSweep="      << getName(fluxSweep, fluxSweepNames)             << '\n'
+         << "writeIntegrals=" << (writeIntegrals ? "true" : "false")            << '\n'
+         << "writeFields="    << (writeFields ? "true" : "false")               << '\n';
+  return stream.str();
+}
+
+std::uint64_t RunDescription::hash() const
+{
+  return getFnv1aHash(serialize());
+}
+
+RunDescription parseRunDescription(std::istream & stream)
+{
+  RunDescription run;
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    line = trim(line.substr(0U, line.find('#')));
+    if (line.empty())
+    {
+      continue;
+    }
+
+    const auto separator = line.find('=');
+    if (separator == std::string::npos)
+    {
+      throw std::invalid_argument("Expected \"key = value\": \"" + line + "\"");
+    }
+
+    const auto key   = trim(line.substr(0U, separator));
+    const auto value = trim(line.substr(separator + 1U));
+    if (key == "shape")
+    {
+      run.shape = getValue(value, shapeNames);
+    }
+    else if (key == "precision")
+    {
+      if ((value != "float") && (value != "double"))
+      {
+        throw std::invalid_argument("Unknown value \"" + value + "\"");
+      }
+
+      run.elemBytes = (value == "double") ? sizeof(double) : sizeof(float);
+    }
+    else if (key == "mode")
+    {
+      run.mode = getValue(value, modeNames);
+    }
+    else if (key == "iterations")
+    {
+      run.iterationCount = parseNumber<unsigned>(key, value);
+    }
+    else if (key == "reinitialize")
+    {
+      run.reinitializeIterationCount = parseNumber<unsigned>(key, value);
+    }
+    else if (key == "courant")
+    {
+      run.courant = parseNumber<double>(key, value);
+    }
+    else if (key == "deltaT")
+    {
+      run.deltaT = parseNumber<double>(key, value);
+    }
+    else if (key == "timeOrder")
+    {
+      run.timeOrder = getValue(value, timeOrderNames);
+    }
+    else if (key == "fluxSweep")
+    {
+      run.fluxSweep = getValue(value, fluxSweepNames);
+    }
+    else if (key == "writeIntegrals")
+    {
+      run.writeIntegrals = parseBool(key, value);
+    }
+    else if (key == "writeFields")
+    {
+      run.writeFields = parseBool(key, value);
+    }
+    else if (key == "output")
+    {
+      run.outputDirectory = std::filesystem::u8path(value).wstring();
+    }
+    else
+    {
+      throw std::invalid_argument("Unknown key \"" + key + "\"");
+    }
+  }
+
+  if ((run.courant <= 0.0) || (run.deltaT < 0.0))
+  {
+    throw std::invalid_argument("Courant number must be positive and deltaT non-negative");
+  }
+
+  return run;
+}
+
+std::string toHexString(std::uint64_t value)
+{
+  std::ostringstream stream;
+  stream << std::hex;
+  stream.width(16);
+  stream.fill('0');
+  stream << value;
+  return stream.str();
+}
+
+} // namespace kae
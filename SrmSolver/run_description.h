@@ -0,0 +1,39 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "discretization_order.h"
+#include "flux_sweep.h"
+#include "shape_types.h"
+
+namespace kae {
+
+enum class EIntegrationMode { eStatic, eDynamic, eLaggedDynamic, eQuasiStationary };
+
+// A queued simulation run. Grid and propellant are compile-time properties of ShapeSolverTypes, so the shape
+// and the precision select them. The output directory is only a delivery target and is not part of the hash.
+struct RunDescription
+{
+  EShapeType               shape{ EShapeType::eWithUmbrellaShape };
+  std::uint32_t            elemBytes{ sizeof(float) };
+  EIntegrationMode         mode{ EIntegrationMode::eDynamic };
+  unsigned                 iterationCount{ 0U };
+  unsigned                 reinitializeIterationCount{ 100U };
+  double                   courant{ 0.8 };
+  double                   deltaT{ 0.0 };
+  ETimeDiscretizationOrder timeOrder{ ETimeDiscretizationOrder::eTwo };
+  EFluxSweep               fluxSweep{ EFluxSweep::eFused };
+  bool                     writeIntegrals{ true };
+  bool                     writeFields{ false };
+  std::wstring             outputDirectory;
+
+  std::string serialize() const;
+  std::uint64_t hash() const;
+};
+
+// Parses "key = value" lines, '#' starts a comment. Throws std::invalid_argument on unknown keys or values.
+RunDescription parseRunDescription(std::istream & stream);
+
+std::string toHexString(std::uint64_t value);
+
+} // namespace kae
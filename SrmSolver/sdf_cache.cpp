@@ -0,0 +1,259 @@
+
+#include "sdf_cache.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kae {
+
+namespace {
+
+std::size_t getValuesOffset(std::size_t keyBytes)
+{
+  constexpr std::size_t alignment{ 64U };
+  return (sizeof(SdfCacheFileHeader) + keyBytes + alignment - 1U) / alignment * alignment;
+}
+
+std::wstring getSdfCachePath(const std::wstring & directory, std::uint64_t hash)
+{
+  std::wostringstream fileName;
+  fileName << L"sdf_" << std::hex;
+  fileName.width(16);
+  fileName.fill(L'0');
+  fileName << hash << L".bin";
+  return (std::filesystem::path{ directory } / fileName.str()).wstring();
+}
+
+} // namespace
+
+std::string SdfCacheKey::serialize() const
+{
+  std::ostringstream stream;
+  stream << shapeName << ';' << std::hex << inputHash << std::dec << ';' << nx << ';' << ny << ';' << std::hexfloat << hx << ';' << hy << ';'
+         << elemBytes << ';' << iterationCount << ';' << timeOrder << ';' << SdfCacheFileHeader::versionValue;
+  return stream.str();
+}
+
+std::uint64_t SdfCacheKey::hash() const
+{
+  return getFnv1aHash(serialize());
+}
+
+std::wstring getSdfCacheDirectory()
+{
+#ifdef _WIN32
+  const wchar_t * pDirectory = _wgetenv(L"KAE_SDF_CACHE_DIR");
+  if (pDirectory != nullptr)
+  {
+    return pDirectory;
+  }
+#else
+  const char * pDirectory = std::getenv("KAE_SDF_CACHE_DIR");
+  if (pDirectory != nullptr)
+  {
+    return std::filesystem::path{ pDirectory }.wstring();
+  }
+#endif
+
+  return {};
+}
+
+SdfCacheFile::SdfCacheFile(const SdfCacheKey & key, std::size_t valueBytes)
+  : SdfCacheFile{ getSdfCacheDirectory(), key, valueBytes }
+{
+}
+
+SdfCacheFile::SdfCacheFile(const std::wstring & directory, const SdfCacheKey & key, std::size_t valueBytes)
+{
+  if (directory.empty())
+  {
+    return;
+  }
+
+  const auto serializedKey = key.serialize();
+  const auto hash          = key.hash();
+  const auto path          = getSdfCachePath(directory, hash);
+  const auto valuesOffset  = getValuesOffset(serializedKey.size());
+
+#ifdef _WIN32
+  const HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return;
+  }
+
+  m_fileHandle = reinterpret_cast<std::intptr_t>(fileHandle);
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(fileHandle, &fileSize) || (static_cast<std::uint64_t>(fileSize.QuadPart) != valuesOffset + valueBytes))
+  {
+    release();
+    return;
+  }
+
+  m_mappedBytes = valuesOffset + valueBytes;
+  const HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0U, 0U, nullptr);
+  if (mappingHandle == nullptr)
+  {
+    release();
+    return;
+  }
+
+  m_mappingHandle = reinterpret_cast<std::intptr_t>(mappingHandle);
+  m_pMapped = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0U, 0U, m_mappedBytes);
+#else
+  const int fileHandle = open(std::filesystem::path{ path }.c_str(), O_RDONLY);
+  if (fileHandle < 0)
+  {
+    return;
+  }
+
+  m_fileHandle = fileHandle;
+  struct stat fileStat;
+  if ((fstat(fileHandle, &fileStat) != 0) || (static_cast<std::uint64_t>(fileStat.st_size) != valuesOffset + valueBytes))
+  {
+    release();
+    return;
+  }
+
+  m_mappedBytes = valuesOffset + valueBytes;
+  void * pMapped = mmap(nullptr, m_mappedBytes, PROT_READ, MAP_SHARED, fileHandle, 0);
+  m_pMapped = (pMapped == MAP_FAILED) ? nullptr : pMapped;
+#endif
+
+  if (m_pMapped == nullptr)
+  {
+    release();
+    return;
+  }
+
+  SdfCacheFileHeader header;
+  std::memcpy(&header, m_pMapped, sizeof(SdfCacheFileHeader));
+  const char * pKey = static_cast<const char *>(m_pMapped) + sizeof(SdfCacheFileHeader);
+  const bool isValid = (header.magic      == SdfCacheFileHeader::magicValue)   &&
+                       (header.version    == SdfCacheFileHeader::versionValue) &&
+                       (header.hash       == hash)                             &&
+                       (header.keyBytes   == serializedKey.size())             &&
+                       (header.valueBytes == valueBytes)                       &&
+                       (serializedKey.compare(0U, serializedKey.size(), pKey, serializedKey.size()) == 0);
+  if (!isValid)
+  {
+    release();
+    return;
+  }
+
+  m_pValues = static_cast<const char *>(m_pMapped) + valuesOffset;
+}
+
+SdfCacheFile::~SdfCacheFile()
+{
+  release();
+}
+
+void SdfCacheFile::release()
+{
+#ifdef _WIN32
+  if (m_pMapped != nullptr)
+  {
+    UnmapViewOfFile(m_pMapped);
+  }
+
+  if (m_mappingHandle != -1)
+  {
+    CloseHandle(reinterpret_cast<HANDLE>(m_mappingHandle));
+  }
+
+  if (m_fileHandle != -1)
+  {
+    CloseHandle(reinterpret_cast<HANDLE>(m_fileHandle));
+  }
+#else
+  if (m_pMapped != nullptr)
+  {
+    munmap(m_pMapped, m_mappedBytes);
+  }
+
+  if (m_fileHandle != -1)
+  {
+    close(static_cast<int>(m_fileHandle));
+  }
+#endif
+
+  m_pMapped       = nullptr;
+  m_pValues       = nullptr;
+  m_mappingHandle = -1;
+  m_fileHandle    = -1;
+}
+
+bool SdfCacheFile::store(const SdfCacheKey & key, const void * pValues, std::size_t valueBytes)
+{
+  return store(getSdfCacheDirectory(), key, pValues, valueBytes);
+}
+
+bool SdfCacheFile::store(const std::wstring & directory, const SdfCacheKey & key, const void * pValues, std::size_t valueBytes)
+{
+  if (directory.empty())
+  {
+    return false;
+  }
+
+  std::error_code errorCode;
+  std::filesystem::create_directories(directory, errorCode);
+
+  const auto serializedKey = key.serialize();
+  const auto hash          = key.hash();
+  const std::filesystem::path path{ getSdfCachePath(directory, hash) };
+
+  // Concurrent runs of a sweep may race for the same entry, so every writer renames its own complete file.
+  auto tempPath = path;
+  tempPath += L"." + std::to_wstring(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+              L"." + std::to_wstring(std::chrono::steady_clock::now().time_since_epoch().count()) + L".tmp";
+  {
+    std::ofstream file{ tempPath, std::ios::binary };
+    if (!file)
+    {
+      return false;
+    }
+
+    const SdfCacheFileHeader header{ SdfCacheFileHeader::magicValue,
+                                     SdfCacheFileHeader::versionValue,
+                                     hash,
+                                     serializedKey.size(),
+                                     valueBytes };
+    const std::vector<char> padding(getValuesOffset(serializedKey.size()) - sizeof(SdfCacheFileHeader) - serializedKey.size());
+    file.write(reinterpret_cast<const char *>(&header), sizeof(SdfCacheFileHeader));
+    file.write(serializedKey.data(), static_cast<std::streamsize>(serializedKey.size()));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(static_cast<const char *>(pValues), static_cast<std::streamsize>(valueBytes));
+    if (!file)
+    {
+      file.close();
+      std::filesystem::remove(tempPath, errorCode);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, errorCode);
+  if (errorCode)
+  {
+    std::filesystem::remove(tempPath, errorCode);
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace kae
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include <typeinfo>
+
+#include "hash_utilities.h"
+
+namespace kae {
+
+struct SdfCacheFileHeader
+{
+  constexpr static std::uint32_t magicValue{ 0x4B414553U };
+  constexpr static std::uint32_t versionValue{ 2U };
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t hash;
+  std::uint64_t keyBytes;
+  std::uint64_t valueBytes;
+};
+
+// Everything the cached field depends on. inputHash covers the values the field is computed from (the contour
+// points or the initial level set), so editing a shape or passing a differently configured instance misses.
+struct SdfCacheKey
+{
+  std::string   shapeName;
+  std::uint64_t inputHash;
+  std::uint32_t nx;
+  std::uint32_t ny;
+  double        hx;
+  double        hy;
+  std::uint32_t elemBytes;
+  std::uint32_t iterationCount;
+  std::uint32_t timeOrder;
+
+  std::string serialize() const;
+  std::uint64_t hash() const;
+};
+
+template <class GpuGridT, class ShapeT>
+SdfCacheKey getSdfCacheKey(const void * pInputs, std::size_t inputBytes, unsigned iterationCount, unsigned timeOrder)
+{
+  return { typeid(ShapeT).name(),
+           getFnv1aHash(pInputs, inputBytes),
+           GpuGridT::nx,
+           GpuGridT::ny,
+           static_cast<double>(GpuGridT::hx),
+           static_cast<double>(GpuGridT::hy),
+           static_cast<std::uint32_t>(sizeof(typename GpuGridT::ElemType)),
+           iterationCount,
+           timeOrder };
+}
+
+// The cache is opt-in: it is enabled by pointing KAE_SDF_CACHE_DIR at a directory, an empty result disables it.
+std::wstring getSdfCacheDirectory();
+
+class SdfCacheFile
+{
+public:
+
+  SdfCacheFile(const SdfCacheKey & key, std::size_t valueBytes);
+  SdfCacheFile(const std::wstring & directory, const SdfCacheKey & key, std::size_t valueBytes);
+  ~SdfCacheFile();
+
+  SdfCacheFile(const SdfCacheFile &) = delete;
+  SdfCacheFile & operator=(const SdfCacheFile &) = delete;
+
+  bool isValid() const { return m_pValues != nullptr; }
+  const void * values() const { return m_pValues; }
+
+  static bool store(const SdfCacheKey & key, const void * pValues, std::size_t valueBytes);
+  static bool store(const std::wstring & directory, const SdfCacheKey & key, const void * pValues, std::size_t valueBytes);
+
+private:
+
+  void release();
+
+private:
+
+  std::size_t   m_mappedBytes{ 0U };
+  void *        m_pMapped{ nullptr };
+  const void *  m_pValues{ nullptr };
+  std::intptr_t m_fileHandle{ -1 };
+  std::intptr_t m_mappingHandle{ -1 };
+};
+
+// Fills pValues from the cache entry of key, or calls computeValues() to fill them and stores the result.
+template <class ElemT, class ComputeFunctionT>
+void loadOrCompute(const std::wstring & directory,
+                   const SdfCacheKey &  key,
+                   ElemT *              pValues,
+                   std::size_t          valueCount,
+                   ComputeFunctionT &&  computeValues)
+{
+  const auto valueBytes = valueCount * sizeof(ElemT);
+  const SdfCacheFile cacheFile{ directory, key, valueBytes };
+  if (cacheFile.isValid())
+  {
+    const auto pCachedValues = static_cast<const ElemT *>(cacheFile.values());
+    std::copy(pCachedValues, pCachedValues + valueCount, pValues);
+    return;
+  }
+
+  computeValues();
+  SdfCacheFile::store(directory, key, pValues, valueBytes);
+}
+
+template <class ElemT, class ComputeFunctionT>
+void loadOrCompute(const SdfCacheKey & key, ElemT * pValues, std::size_t valueCount, ComputeFunctionT && computeValues)
+{
+  loadOrCompute(getSdfCacheDirectory(), key, pValues, valueCount, std::forward<ComputeFunctionT>(computeValues));
+}
+
+} // namespace kae
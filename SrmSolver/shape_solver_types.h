@@ -2,7 +2,9 @@
 
 #include "std_includes.h"
 
+#include "burn_back_ballistics_solver.h"
 #include "gas_state.h"
+#include "gpu_burn_back_solver.h"
 #include "gpu_grid.h"
 #include "gpu_level_set_solver.h"
 #include "gpu_srm_solver.h"
@@ -41,6 +43,8 @@ struct ShapeSolverTypes<EShapeType::eDualThrustShape, ElemT>
 
   using LevelSetSolverType = GpuLevelSetSolver<GpuGridType, ShapeType>;
   using SrmSolverType = GpuSrmSolver<GpuGridType, ShapeType, GasStateType, PhysicalPropertiesType>;
+  using BurnBackSolverType = GpuBurnBackSolver<GpuGridType, ShapeType>;
+  using BallisticsSolverType = BurnBackBallisticsSolver<ShapeType, PhysicalPropertiesType>;
 
   constexpr static GasStateType initialGasState{ static_cast<ElemT>(1.0),
                                                  static_cast<ElemT>(0.0),
@@ -75,6 +79,8 @@ struct ShapeSolverTypes<EShapeType::eNozzleLessShape, ElemT>
 
   using LevelSetSolverType = GpuLevelSetSolver<GpuGridType, ShapeType>;
   using SrmSolverType      = GpuSrmSolver<GpuGridType, ShapeType, GasStateType, PhysicalPropertiesType>;
+  using BurnBackSolverType = GpuBurnBackSolver<GpuGridType, ShapeType>;
+  using BallisticsSolverType = BurnBackBallisticsSolver<ShapeType, PhysicalPropertiesType>;
 
   constexpr static GasStateType initialGasState{ static_cast<ElemT>(1.0),
                                                  static_cast<ElemT>(0.0),
@@ -109,6 +115,8 @@ struct ShapeSolverTypes<EShapeType::eWithUmbrellaShape, ElemT>
 
   using LevelSetSolverType = GpuLevelSetSolver<GpuGridType, ShapeType>;
   using SrmSolverType = GpuSrmSolver<GpuGridType, ShapeType, GasStateType, PhysicalPropertiesType>;
+  using BurnBackSolverType = GpuBurnBackSolver<GpuGridType, ShapeType>;
+  using BallisticsSolverType = BurnBackBallisticsSolver<ShapeType, PhysicalPropertiesType>;
 
   constexpr static GasStateType initialGasState{ static_cast<ElemT>(0.5),
                                                  static_cast<ElemT>(0.0),
@@ -143,6 +151,8 @@ struct ShapeSolverTypes<EShapeType::eFlushMountedNozzle, ElemT>
 
   using LevelSetSolverType = GpuLevelSetSolver<GpuGridType, ShapeType>;
   using SrmSolverType = GpuSrmSolver<GpuGridType, ShapeType, GasStateType, PhysicalPropertiesType>;
+  using BurnBackSolverType = GpuBurnBackSolver<GpuGridType, ShapeType>;
+  using BallisticsSolverType = BurnBackBallisticsSolver<ShapeType, PhysicalPropertiesType>;
 
   constexpr static GasStateType initialGasState{ static_cast<ElemT>(0.5),
                                                  static_cast<ElemT>(0.0),
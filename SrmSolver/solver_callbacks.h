@@ -2,84 +2,174 @@
 
 #include "std_includes.h"
 
+#include <filesystem>
+
+#include "analysis_pipeline.h"
 #include "cuda_float_types.h"
 #include "filesystem.h"
 #include "gas_state.h"
-#include "gnu_plot_wrapper.h"
+#include "geometry_planes.h"
+#include "gpu_downsample_kernel.h"
 #include "gpu_matrix.h"
 #include "gpu_matrix_writer.h"
+#include "integral_data.h"
+#include "live_view_ring.h"
 #include "solver_reduction_functions.h"
 
 
 namespace kae {
 
-namespace detail {
+template <class ElemT>
+class CollectIntegralsCallback
+{
+public:
+
+  template <class GpuGridT,
+            class GasStateT,
+            class ShapeT>
+  void operator()(const GpuMatrix<GpuGridT, GasStateT> & gasValues,
+                  const GpuMatrix<GpuGridT, ElemT> &,
+                  unsigned, ElemT t, CudaFloat4T<ElemT>, ElemT sBurn,
+                  const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+                  const GeometryPlanes<GpuGridT, ShapeT> &  geometryPlanes)
+  {
+    m_values.push_back(detail::getIntegralData(gasValues, cellClasses, geometryPlanes, t, sBurn));
+  }
+
+  template <class GpuGridT, class GasStateT>
+  void operator()(const GpuMatrix<GpuGridT, GasStateT> &, const GpuMatrix<GpuGridT, ElemT> &)
+  {
+  }
+
+  const std::vector<IntegralData<ElemT>> & values() const { return m_values; }
 
-class ThreadWorker
+private:
+
+  std::vector<IntegralData<ElemT>> m_values;
+};
+
+template <class ElemT>
+class LiveViewCallback
 {
 public:
 
-  ThreadWorker()
-    : m_thread([this]()
-      {
-        while (m_bContinue)
-        {
-          std::unique_lock<std::mutex> locker(m_mutex);
-          m_conditionVariable.wait(locker, [this]() { return m_bReady; });
-          m_function();
-          m_bReady = false;
-        }
-      })
-  {}
-
-  ~ThreadWorker()
+  LiveViewCallback(const std::wstring & ringPath,
+                   std::uint32_t        slotCount     = 16U,
+                   std::uint32_t        maxValueCount = 1U << 16U)
+    : m_pRing(std::make_unique<LiveViewRing>(ringPath, slotCount, maxValueCount))
   {
-    m_bContinue = false;
-    m_bReady = true;
-    m_function = []() {};
-    m_conditionVariable.notify_one();
+    if ((cudaHostAlloc(reinterpret_cast<void **>(&m_pHostFrame), maxValueCount * sizeof(float), cudaHostAllocDefault) != cudaSuccess) ||
+        (cudaEventCreateWithFlags(&m_frameCopied, cudaEventDisableTiming) != cudaSuccess))
+    {
+      cudaFreeHost(m_pHostFrame);
+      throw std::runtime_error("Unable to allocate live view staging buffer");
+    }
+  }
+
+  ~LiveViewCallback()
+  {
+    if (m_bFramePending && (cudaEventSynchronize(m_frameCopied) == cudaSuccess))
+    {
+      publishPendingFrame();
+    }
+
+    cudaEventDestroy(m_frameCopied);
+    cudaFreeHost(m_pHostFrame);
+  }
+
+  LiveViewCallback(const LiveViewCallback &) = delete;
+  LiveViewCallback & operator=(const LiveViewCallback &) = delete;
+
+  template <class GpuGridT,
+            class GasStateT,
+            class ShapeT>
+  void operator()(const GpuMatrix<GpuGridT, GasStateT> & gasValues,
+                  const GpuMatrix<GpuGridT, ElemT> &,
+                  unsigned i, ElemT t, CudaFloat4T<ElemT> maxDerivatives, ElemT sBurn,
+                  const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+                  const GeometryPlanes<GpuGridT, ShapeT> &  geometryPlanes)
+  {
+    const auto meanPressure = detail::getCalculatedBoriPressure(gasValues.values(), cellClasses.values(), geometryPlanes);
+    publishIntegrals(i, t, meanPressure, sBurn, maxDerivatives);
   }
 
-  template <class FunctorT>
-  bool trySubmit(FunctorT && functor)
+  // Never waits for the device. The frame is copied into pinned memory asynchronously and published by a later
+  // call once its copy has finished, frames arriving while a copy is still in flight are dropped.
+  template <class GpuGridT, class GasStateT>
+  void operator()(const GpuMatrix<GpuGridT, GasStateT> & gasValues,
+                  const GpuMatrix<GpuGridT, ElemT> & phiValues)
   {
-    if (m_mutex.try_lock())
+    if (m_bFramePending)
     {
-      m_function = functor;
-      m_bReady = true;
-      m_mutex.unlock();
-      m_conditionVariable.notify_one();
-      return true;
+      if (cudaEventQuery(m_frameCopied) == cudaErrorNotReady)
+      {
+        return;
+      }
+
+      publishPendingFrame();
     }
 
-    return false;
+    const auto factor  = detail::getDownsampleFactor<GpuGridT>(m_pRing->maxValueCount());
+    const auto frameNx = (GpuGridT::nx + factor - 1U) / factor;
+    const auto frameNy = (GpuGridT::ny + factor - 1U) / factor;
+
+    m_devFrame.resize(frameNx * frameNy);
+    detail::downsamplePressureWrapper<GpuGridT>(getDevicePtr(gasValues), getDevicePtr(phiValues),
+                                                m_devFrame.data(), factor, frameNx, frameNy);
+    cudaMemcpyAsync(m_pHostFrame, m_devFrame.data().get(), m_devFrame.size() * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaEventRecord(m_frameCopied);
+
+    m_pendingIteration = m_iteration;
+    m_pendingT         = m_t;
+    m_pendingNx        = frameNx;
+    m_pendingNy        = frameNy;
+    m_bFramePending    = true;
+  }
+
+  void publishIntegrals(unsigned i, ElemT t, ElemT meanPressure, ElemT sBurn, CudaFloat4T<ElemT> maxDerivatives)
+  {
+    m_iteration = i;
+    m_t         = static_cast<double>(t);
+
+    const float integrals[] = { static_cast<float>(meanPressure),     static_cast<float>(sBurn),
+                                static_cast<float>(maxDerivatives.x), static_cast<float>(maxDerivatives.y),
+                                static_cast<float>(maxDerivatives.z), static_cast<float>(maxDerivatives.w) };
+    m_pRing->publish(ELiveViewFrameKind::eIntegrals, m_iteration, m_t,
+                     static_cast<std::uint32_t>(std::size(integrals)), 1U, integrals);
   }
 
 private:
 
-  std::thread m_thread;
-  std::function<void()> m_function;
-  std::mutex m_mutex;
-  std::condition_variable m_conditionVariable;
-  bool m_bReady = false;
-  bool m_bContinue = true;
+  void publishPendingFrame()
+  {
+    m_pRing->publish(ELiveViewFrameKind::eField, m_pendingIteration, m_pendingT, m_pendingNx, m_pendingNy, m_pHostFrame);
+    m_bFramePending = false;
+  }
 
-};
+private:
 
-} // namespace detail
+  std::unique_ptr<LiveViewRing> m_pRing;
+  thrust::device_vector<float>  m_devFrame;
+  float *                       m_pHostFrame{ nullptr };
+  cudaEvent_t                   m_frameCopied{ nullptr };
+  bool                          m_bFramePending{ false };
+  unsigned                      m_pendingIteration{ 0U };
+  double                        m_pendingT{ 0.0 };
+  std::uint32_t                 m_pendingNx{ 0U };
+  std::uint32_t                 m_pendingNy{ 0U };
+  unsigned                      m_iteration{ 0U };
+  double                        m_t{ 0.0 };
+};
 
 template <class ElemT>
 class WriteToFolderCallback
 {
 public:
 
-  WriteToFolderCallback(std::wstring folderPath, 
-                        std::string pathToGnuPlot = "\"C:\\Program Files\\gnuplot\\bin\\gnuplot.exe\"")
-    : m_folderPath(std::move(folderPath)),
-      m_gnuPlotTemperature(pathToGnuPlot)
+  WriteToFolderCallback(std::wstring folderPath)
+    : m_folderPath(resetFolder(std::move(folderPath))),
+      m_liveView(kae::append(m_folderPath, L"live_view.bin"))
   {
-    kae::remove_all(m_folderPath);
-    kae::create_directories(m_folderPath);
     kae::current_path(m_folderPath);
   }
 
@@ -88,16 +178,12 @@ public:
             class ShapeT>
   void operator()(const GpuMatrix<GpuGridT, GasStateT> & gasValues,
                   const GpuMatrix<GpuGridT, ElemT> & currPhi,
-                  unsigned i, ElemT t, CudaFloat4T<ElemT> maxDerivatives, ElemT sBurn, ShapeT)
+                  unsigned i, ElemT t, CudaFloat4T<ElemT> maxDerivatives, ElemT sBurn,
+                  const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+                  const GeometryPlanes<GpuGridT, ShapeT> &  geometryPlanes)
   {
-    const auto meanPressure   = detail::getCalculatedBoriPressure<GpuGridT, ShapeT>(gasValues.values(), currPhi.values());
-    const auto maxPressure    = detail::getMaxChamberPressure<GpuGridT, ShapeT>(gasValues.values(), currPhi.values());
-    const auto thrustData     = detail::getMotorThrust<GpuGridT, ShapeT>(gasValues.values(), currPhi.values());
-    const auto massFlowRate   = thrust::get<2U>(thrustData);
-    const auto velocity       = thrust::get<1U>(thrustData) / thrust::get<0U>(thrustData);
-    const auto thrust         = massFlowRate * velocity + thrust::get<3U>(thrustData);
-    const auto specificThrust = thrust / massFlowRate;
-    m_meanPressureValues.emplace_back(t, meanPressure, maxPressure, sBurn, thrust, specificThrust, velocity);
+    m_meanPressureValues.push_back(detail::getIntegralData(gasValues, cellClasses, geometryPlanes, t, sBurn));
+    m_liveView.publishIntegrals(i, t, std::get<1U>(m_meanPressureValues.back()), sBurn, maxDerivatives);
 
     const auto writeToFile = [this](std::vector<IntegralDataT> meanPressureValues,
       GpuMatrix<GpuGridT, GasStateT> gasValues,
@@ -117,14 +203,7 @@ public:
       kae::current_path(newCurrentPath);
 
       std::ofstream meanPressureFile{ "mean_pressure_values.dat" };
-      meanPressureFile << "t;P_av;P_max;S;Thrust;specThrust;velocity\n";
-      for (const auto& elem : meanPressureValues)
-      {
-        meanPressureFile << std::get<0U>(elem) << ';' << std::get<1U>(elem) << ';'
-                         << std::get<2U>(elem) << ';' << std::get<3U>(elem) << ';'
-                         << std::get<4U>(elem) << ';' << std::get<5U>(elem) << ';'
-                         << std::get<6U>(elem) <<'\n';
-      }
+      writeIntegralData(meanPressureFile, meanPressureValues);
       writeMatrixToFile(currPhi, "sgd.dat");
       writeMatrixToFile(gasValues, "p.dat", "ux.dat", "uy.dat", "mach.dat", "T.dat");
     };
@@ -136,43 +215,83 @@ public:
   void operator()(const GpuMatrix<GpuGridT, GasStateT> & gasValues,
     const GpuMatrix<GpuGridT, ElemT> & phiValues)
   {
-    const auto func = [&]()
-    {
-      thrust::host_vector<GasStateT> hostGasStateValues(gasValues.values());
-      thrust::host_vector<ElemT> hostPhiValues(phiValues.values());
-      drawTemperature<GpuGridT>(std::move(hostGasStateValues), std::move(hostPhiValues));
-    };
-    m_threadWorker.trySubmit(func);
+    m_liveView(gasValues, phiValues);
   }
 
 private:
 
-  using IntegralDataT = std::tuple<ElemT, ElemT, ElemT, ElemT, ElemT, ElemT, ElemT>;
+  using IntegralDataT = IntegralData<ElemT>;
 
-  template <class GpuGridT, class GasStateT, class ElemT = typename GasStateT::ElemType>
-  void drawTemperature(thrust::host_vector<GasStateT> hostGasStateValues,
-                       thrust::host_vector<ElemT> hostPhiValues)
+  static std::wstring resetFolder(std::wstring folderPath)
   {
-    std::vector<std::vector<std::tuple<ElemT, ElemT, ElemT>>> gridTemperatureValues;
-    for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
-    {
-      std::vector<std::tuple<ElemT, ElemT, ElemT>> rowTemperatureValues(GpuGridT::nx);
-      for (unsigned i{}; i < GpuGridT::nx; ++i)
-      {
-        const auto x = i * GpuGridT::hx;
-        const auto y = j * GpuGridT::hy;
-        rowTemperatureValues[i] = std::make_tuple(x, y, P::get(hostGasStateValues[j * GpuGridT::nx + i]));
-      };
-      gridTemperatureValues.push_back(std::move(rowTemperatureValues));
-    }
-    m_gnuPlotTemperature.display2dPlot(gridTemperatureValues);
+    kae::remove_all(folderPath);
+    kae::create_directories(folderPath);
+    return folderPath;
   }
 
 private:
   std::wstring               m_folderPath;
-  GnuPlotWrapper             m_gnuPlotTemperature;
+  LiveViewCallback<ElemT>    m_liveView;
   std::vector<IntegralDataT> m_meanPressureValues;
-  detail::ThreadWorker       m_threadWorker;
+};
+
+// Analysis plugin writing integrals and fields into a subfolder per frame. Mach and temperature come from the
+// solver's derived-field pass and are only requested when they are going to be written. Subscribe it through
+// AnalysisPipeline::subscribe(cadence, plugin) so that the frames carry its quantities().
+template <class GpuGridT, class GasStateT>
+class WriteFieldsPlugin
+{
+public:
+
+  using ElemType  = typename GasStateT::ElemType;
+  using FrameType = AnalysisFrame<GpuGridT, GasStateT>;
+
+  WriteFieldsPlugin(std::wstring folderPath, bool writeDerivedFields)
+    : m_folderPath{ std::move(folderPath) },
+      m_writeDerivedFields{ writeDerivedFields }
+  {
+    std::filesystem::create_directories(m_folderPath);
+  }
+
+  std::uint32_t quantities() const
+  {
+    return AnalysisQuantity::integrals |
+      (m_writeDerivedFields ? (AnalysisQuantity::mach | AnalysisQuantity::temperature) : 0U);
+  }
+
+  void operator()(const FrameType & frame)
+  {
+    if (!frame.integrals)
+    {
+      throw std::runtime_error("WriteFieldsPlugin requires integrals in every frame");
+    }
+
+    m_integrals.push_back(*frame.integrals);
+
+    const std::filesystem::path folder = m_folderPath / std::to_wstring(frame.t);
+    std::filesystem::create_directories(folder);
+
+    std::ofstream integralsFile{ folder / L"mean_pressure_values.dat" };
+    writeIntegralData(integralsFile, m_integrals);
+    writeMatrixToFile(frame.currPhi, (folder / L"sgd.dat").string());
+    writeMatrixToFile(frame.gasValues, (folder / L"p.dat").string(), (folder / L"ux.dat").string(),
+                      (folder / L"uy.dat").string());
+    if (frame.pMach)
+    {
+      writeMatrixToFile(*frame.pMach, (folder / L"mach.dat").string());
+    }
+
+    if (frame.pTemperature)
+    {
+      writeMatrixToFile(*frame.pTemperature, (folder / L"T.dat").string());
+    }
+  }
+
+private:
+
+  std::filesystem::path               m_folderPath;
+  bool                                m_writeDerivedFields;
+  std::vector<IntegralData<ElemType>> m_integrals;
 };
 
 } // namespace kae
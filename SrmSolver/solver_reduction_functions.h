@@ -2,24 +2,20 @@
 
 #include "cuda_includes.h"
 
+#include "cell_class.h"
 #include "cuda_float_types.h"
 #include "delta_dirac_function.h"
 #include "float4_arithmetics.h"
 #include "gas_state.h"
+#include "geometry_planes.h"
+#include "gpu_matrix.h"
+#include "integral_data.h"
 #include "math_utilities.h"
 
 namespace kae {
 
 namespace detail {
 
-template <class ElemT>
-thrust::device_vector<ElemT> generateIndexMatrix(unsigned n)
-{
-  thrust::device_vector<ElemT> indexMatrix(n);
-  thrust::sequence(std::begin(indexMatrix), std::end(indexMatrix));
-  return indexMatrix;
-}
-
 template <class GasStateT, class ElemT = typename GasStateT::ElemType>
 CudaFloat2T<ElemT> getMaxWaveSpeeds(const thrust::device_vector<GasStateT>& values)
 {
@@ -54,102 +50,85 @@ CudaFloat4T<ElemT> getMaxEquationDerivatives(const thrust::device_vector<GasStat
   return (1 / dt) * thrust::transform_reduce(zipFirst, zipLast, toDerivatives, CudaFloat4T<ElemT>{}, ElemwiseAbsMax{});
 }
 
-template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
-ElemT getChamberVolume(const thrust::device_vector<ElemT> & currPhi)
+// The radius plane evaluated on the fly, for callers that have no GeometryPlanes.
+template <class GpuGridT, class ShapeT>
+struct FlatIndexRadius
 {
-  static thread_local auto indexVector = generateIndexMatrix<unsigned>(static_cast<unsigned>(currPhi.size()));
-
-  const auto zipFirst = thrust::make_zip_iterator(thrust::make_tuple(std::begin(indexVector), std::begin(currPhi)));
-  const auto zipLast  = thrust::make_zip_iterator(thrust::make_tuple(std::end(indexVector), std::end(currPhi)));
-
-  const auto toVolume = [] __device__ (const thrust::tuple<unsigned, ElemT> & tuple)
+  HOST_DEVICE typename GpuGridT::ElemType operator()(unsigned index) const
   {
-    const auto i         = thrust::get<0U>(tuple) % GpuGridT::nx;
-    const auto j         = thrust::get<0U>(tuple) / GpuGridT::nx;
-    if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny) || !ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy))
-    {
-      return static_cast<ElemT>(0.0);
-    }
+    return RadiusInitializer<GpuGridT, ShapeT>{}(index % GpuGridT::nx, index / GpuGridT::nx);
+  }
+};
 
-    return ((thrust::get<1U>(tuple) > 0) ? static_cast<ElemT>(0.0) : 
-      2 * static_cast<ElemT>(M_PI) * ShapeT::getRadius(i, j) * GpuGridT::hx * GpuGridT::hy);
-  };
-
-  return thrust::transform_reduce(zipFirst, zipLast, toVolume, static_cast<ElemT>(0.0), thrust::plus<ElemT>{});
-}
-
-template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
-ElemT getPressureIntegral(const thrust::device_vector<GasStateT>& gasValues,
-                          const thrust::device_vector<ElemT>& currPhi)
+template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
+struct LevelIsChamberFluid
 {
-  static thread_local auto indexVector = generateIndexMatrix<unsigned>(static_cast<unsigned>(currPhi.size()));
-
-  const auto zipFirst = thrust::make_zip_iterator(
-    thrust::make_tuple(std::begin(gasValues), std::begin(indexVector), std::begin(currPhi)));
-  const auto zipLast = thrust::make_zip_iterator(
-    thrust::make_tuple(std::end(gasValues), std::end(indexVector), std::end(currPhi)));
+  HOST_DEVICE bool operator()(const thrust::tuple<unsigned, ElemT> & tuple) const
+  {
+    const auto i = thrust::get<0U>(tuple) % GpuGridT::nx;
+    const auto j = thrust::get<0U>(tuple) / GpuGridT::nx;
+    return (thrust::get<1U>(tuple) <= 0) && ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy);
+  }
+};
 
-  const auto toVolume = [] __device__ (const thrust::tuple<GasStateT, unsigned, ElemT> & tuple)
+struct CellClassIsChamberFluid
+{
+  HOST_DEVICE bool operator()(std::uint8_t cellClass) const
   {
-    const auto i = thrust::get<1U>(tuple) % GpuGridT::nx;
-    const auto j = thrust::get<1U>(tuple) / GpuGridT::nx;
-    if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny) || !ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy))
-    {
-      return static_cast<ElemT>(0.0);
-    }
+    return CellClass::is(cellClass, CellClass::fluid) && !CellClass::is(cellClass, CellClass::outsideChamber);
+  }
+};
+
+// The level-set and the cell-class overloads below only differ in where the chamber flags and radii come from. The
+// level-set ones serve GpuBurnBackSolver, which has no cell classes, the gas-dynamic solver uses the cell-class ones.
+template <class GpuGridT, class ChamberIteratorT, class RadiusIteratorT, class ElemT = typename GpuGridT::ElemType>
+ElemT getChamberVolumeImpl(ChamberIteratorT isChamberFluid, RadiusIteratorT radii)
+{
+  const auto zipFirst = thrust::make_zip_iterator(thrust::make_tuple(isChamberFluid, radii));
+  const auto zipLast  = zipFirst + GpuGridT::n;
 
-    return ((thrust::get<2U>(tuple) > 0) ? static_cast<ElemT>(0.0) : 
-      2 * static_cast<ElemT>(M_PI) * ShapeT::getRadius(i, j) * P::get(thrust::get<0U>(tuple)) * GpuGridT::hx * GpuGridT::hy);
+  const auto toVolume = [] __device__ (const thrust::tuple<bool, ElemT> & tuple)
+  {
+    return thrust::get<0U>(tuple) ? 2 * static_cast<ElemT>(M_PI) * thrust::get<1U>(tuple) * GpuGridT::hx * GpuGridT::hy :
+                                    static_cast<ElemT>(0.0);
   };
 
   return thrust::transform_reduce(zipFirst, zipLast, toVolume, static_cast<ElemT>(0.0), thrust::plus<ElemT>{});
 }
 
-template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
-ElemT getMaxChamberPressure(const thrust::device_vector<GasStateT>& gasValues,
-                            const thrust::device_vector<ElemT>& currPhi)
+template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
+ElemT getChamberVolume(const thrust::device_vector<ElemT> & currPhi)
 {
-  static thread_local auto indexVector = generateIndexMatrix<unsigned>(static_cast<unsigned>(currPhi.size()));
-
-  const auto zipFirst = thrust::make_zip_iterator(
-    thrust::make_tuple(std::begin(gasValues), std::begin(indexVector), std::begin(currPhi)));
-  const auto zipLast = thrust::make_zip_iterator(
-    thrust::make_tuple(std::end(gasValues), std::end(indexVector), std::end(currPhi)));
-
-  const auto toPressure = [] __device__(const thrust::tuple<GasStateT, unsigned, ElemT> & tuple)
-  {
-    const auto i = thrust::get<1U>(tuple) % GpuGridT::nx;
-    const auto j = thrust::get<1U>(tuple) / GpuGridT::nx;
-    if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny) || !ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy))
-    {
-      return static_cast<ElemT>(0.0);
-    }
-
-    return ((thrust::get<2U>(tuple) > 0) ? static_cast<ElemT>(0.0) : P::get(thrust::get<0U>(tuple)));
-  };
-
-  return thrust::transform_reduce(zipFirst, zipLast, toPressure, static_cast<ElemT>(0.0), thrust::maximum<ElemT>{});
+  const auto indexFirst = thrust::make_counting_iterator(0U);
+  const auto levelFirst = thrust::make_zip_iterator(thrust::make_tuple(indexFirst, std::begin(currPhi)));
+  return getChamberVolumeImpl<GpuGridT>(
+    thrust::make_transform_iterator(levelFirst, LevelIsChamberFluid<GpuGridT, ShapeT>{}),
+    thrust::make_transform_iterator(indexFirst, FlatIndexRadius<GpuGridT, ShapeT>{}));
 }
 
-template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
-ElemT getCalculatedBoriPressure(const thrust::device_vector<GasStateT>& gasValues,
-                                const thrust::device_vector<ElemT>& currPhi)
+template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
+ElemT getChamberVolume(const thrust::device_vector<std::uint8_t> & cellClasses,
+                       const GeometryPlanes<GpuGridT, ShapeT> &    geometryPlanes)
 {
-  return getPressureIntegral<GpuGridT, ShapeT>(gasValues, currPhi) / getChamberVolume<GpuGridT, ShapeT>(currPhi);
+  return getChamberVolumeImpl<GpuGridT>(
+    thrust::make_transform_iterator(std::begin(cellClasses), CellClassIsChamberFluid{}),
+    std::begin(geometryPlanes.radii().values()));
 }
 
-template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
-ElemT getBurningSurface(const thrust::device_vector<ElemT>& currPhi,
-                        const thrust::device_vector<CudaFloat2T<ElemT>>& normals)
+template <class GpuGridT, class ShapeT, class RadiusIteratorT, class ElemT = typename GpuGridT::ElemType>
+ElemT getBurningSurfaceImpl(const thrust::device_vector<ElemT> &              currPhi,
+                            const thrust::device_vector<CudaFloat2T<ElemT>> & normals,
+                            RadiusIteratorT                                   radii)
 {
-  static thread_local auto indexVector = generateIndexMatrix<unsigned>(static_cast<unsigned>(currPhi.size()));
+  const auto indexFirst = thrust::make_counting_iterator(0U);
+  const auto indexLast  = indexFirst + static_cast<unsigned>(currPhi.size());
 
   const auto zipFirst = thrust::make_zip_iterator(
-    thrust::make_tuple(std::begin(indexVector), std::begin(currPhi), std::begin(normals)));
+    thrust::make_tuple(indexFirst, std::begin(currPhi), std::begin(normals), radii));
   const auto zipLast = thrust::make_zip_iterator(
-    thrust::make_tuple(std::end(indexVector), std::end(currPhi), std::end(normals)));
+    thrust::make_tuple(indexLast, std::end(currPhi), std::end(normals), radii + currPhi.size()));
 
-  const auto toVolume = [] __device__(const thrust::tuple<unsigned, ElemT, CudaFloat2T<ElemT>> & tuple)
+  const auto toSurface = [] __device__(const thrust::tuple<unsigned, ElemT, CudaFloat2T<ElemT>, ElemT> & tuple)
   {
     const auto level   = thrust::get<1U>(tuple);
     const auto normals = thrust::get<2U>(tuple);
@@ -158,27 +137,39 @@ ElemT getBurningSurface(const thrust::device_vector<ElemT>& currPhi,
     const auto j = thrust::get<0U>(tuple) / GpuGridT::nx;
     const auto xSurface = i * GpuGridT::hx - level * normals.x;
     const auto ySurface = j * GpuGridT::hy - level * normals.y;
-    if ((i >= GpuGridT::nx) || (j >= GpuGridT::ny) || !ShapeT::isBurningSurface(xSurface, ySurface))
+    if (!ShapeT::isBurningSurface(xSurface, ySurface))
     {
       return static_cast<ElemT>(0.0);
     }
 
-    const auto y = ShapeT::getRadius(i, j);
+    const auto y = thrust::get<3U>(tuple);
     return 2 * static_cast<ElemT>(M_PI) * y * deltaDiracFunction(level, GpuGridT::hx) * GpuGridT::hx * GpuGridT::hy;
   };
 
-  return thrust::transform_reduce(zipFirst, zipLast, toVolume, static_cast<ElemT>(0.0), thrust::plus<ElemT>{});
+  return thrust::transform_reduce(zipFirst, zipLast, toSurface, static_cast<ElemT>(0.0), thrust::plus<ElemT>{});
 }
 
-template <class GpuGridT,
-          class ShapeT,
-          class PhysicalPropertiesT,
-          class ElemT = typename GpuGridT::ElemType>
-ElemT getTheoreticalBoriPressure(const thrust::device_vector<ElemT>& currPhi,
-                                 const thrust::device_vector<CudaFloat2T<ElemT>>& normals)
+template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
+ElemT getBurningSurface(const thrust::device_vector<ElemT>& currPhi,
+                        const thrust::device_vector<CudaFloat2T<ElemT>>& normals)
+{
+  return getBurningSurfaceImpl<GpuGridT, ShapeT>(
+    currPhi, normals, thrust::make_transform_iterator(thrust::make_counting_iterator(0U),
+                                                      FlatIndexRadius<GpuGridT, ShapeT>{}));
+}
+
+template <class GpuGridT, class ShapeT, class ElemT = typename GpuGridT::ElemType>
+ElemT getBurningSurface(const thrust::device_vector<ElemT> &              currPhi,
+                        const thrust::device_vector<CudaFloat2T<ElemT>> & normals,
+                        const GeometryPlanes<GpuGridT, ShapeT> &          geometryPlanes)
+{
+  return getBurningSurfaceImpl<GpuGridT, ShapeT>(currPhi, normals, std::begin(geometryPlanes.radii().values()));
+}
+
+template <class ShapeT, class PhysicalPropertiesT, class ElemT>
+ElemT getTheoreticalBoriPressureFromSurface(ElemT burningSurface)
 {
   constexpr auto kappa = PhysicalPropertiesT::kappa;
-  const auto burningSurface = getBurningSurface<GpuGridT, ShapeT>(currPhi, normals);
   const auto boriPressure = std::pow(
     burningSurface * PhysicalPropertiesT::mt * std::sqrt((kappa - 1) / kappa * PhysicalPropertiesT::H0) /
     PhysicalPropertiesT::gammaComplex / ShapeT::getFCritical(), 1 / (1 - PhysicalPropertiesT::nu));
@@ -187,48 +178,109 @@ ElemT getTheoreticalBoriPressure(const thrust::device_vector<ElemT>& currPhi,
 
 template <class GpuGridT,
           class ShapeT,
-          class GasStateT,
-          class ElemT      = typename GpuGridT::ElemType,
-          class ReturnType = thrust::tuple<ElemT, ElemT, ElemT, ElemT>>
-ReturnType getMotorThrust(const thrust::device_vector<GasStateT> & gasValues,
-                          const thrust::device_vector<ElemT> &     currPhi)
+          class PhysicalPropertiesT,
+          class ElemT = typename GpuGridT::ElemType>
+ElemT getTheoreticalBoriPressure(const thrust::device_vector<ElemT> &              currPhi,
+                                 const thrust::device_vector<CudaFloat2T<ElemT>> & normals,
+                                 const GeometryPlanes<GpuGridT, ShapeT> &          geometryPlanes)
 {
-  static thread_local auto indexVector = generateIndexMatrix<unsigned>(static_cast<unsigned>(currPhi.size()));
+  const auto burningSurface = getBurningSurface<GpuGridT, ShapeT>(currPhi, normals, geometryPlanes);
+  return getTheoreticalBoriPressureFromSurface<ShapeT, PhysicalPropertiesT>(burningSurface);
+}
+
+// Everything getIntegralData needs from the grid, gathered in one pass instead of one reduction per integral.
+template <class ElemT>
+struct ChamberSums
+{
+  ElemT volume;
+  ElemT pressureIntegral;
+  ElemT maxPressure;
+  ElemT outletArea;
+  ElemT outletVelocity;
+  ElemT outletMassFlow;
+  ElemT outletPressure;
+
+  HOST_DEVICE ChamberSums operator+(const ChamberSums & rhs) const
+  {
+    return ChamberSums{ volume + rhs.volume,
+                        pressureIntegral + rhs.pressureIntegral,
+                        thrust::max(maxPressure, rhs.maxPressure),
+                        outletArea + rhs.outletArea,
+                        outletVelocity + rhs.outletVelocity,
+                        outletMassFlow + rhs.outletMassFlow,
+                        outletPressure + rhs.outletPressure };
+  }
+};
+
+template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
+ChamberSums<ElemT> getChamberSums(const thrust::device_vector<GasStateT> &    gasValues,
+                                  const thrust::device_vector<std::uint8_t> & cellClasses,
+                                  const GeometryPlanes<GpuGridT, ShapeT> &    geometryPlanes)
+{
+  const auto & radii = geometryPlanes.radii().values();
+  const auto indexFirst = thrust::make_counting_iterator(0U);
+  const auto indexLast  = indexFirst + static_cast<unsigned>(gasValues.size());
 
   const auto zipFirst = thrust::make_zip_iterator(
-    thrust::make_tuple(std::begin(gasValues), std::begin(indexVector), std::begin(currPhi)));
+    thrust::make_tuple(std::begin(gasValues), indexFirst, std::begin(cellClasses), std::begin(radii)));
   const auto zipLast = thrust::make_zip_iterator(
-    thrust::make_tuple(std::end(gasValues), std::end(indexVector), std::end(currPhi)));
+    thrust::make_tuple(std::end(gasValues), indexLast, std::end(cellClasses), std::end(radii)));
 
-  const auto toThrust = [] __device__(const thrust::tuple<GasStateT, unsigned, ElemT> & tuple)
+  const auto toSums = [] __device__(const thrust::tuple<GasStateT, unsigned, std::uint8_t, ElemT> & tuple)
   {
     const auto i = thrust::get<1U>(tuple) % GpuGridT::nx;
-    const auto j = thrust::get<1U>(tuple) / GpuGridT::nx;
-    const auto r = ShapeT::getRadius(i, j);
-    const auto isInside = thrust::get<2U>(tuple) < static_cast<ElemT>(0.0);
+    const auto cellClass = thrust::get<2U>(tuple);
+    const auto & gasState = thrust::get<0U>(tuple);
+    const auto r = thrust::get<3U>(tuple);
+    const auto p = P::get(gasState);
+
+    ChamberSums<ElemT> sums{};
+    if (CellClassIsChamberFluid{}(cellClass))
+    {
+      const auto dV = 2 * static_cast<ElemT>(M_PI) * r * GpuGridT::hx * GpuGridT::hy;
+      sums.volume           = dV;
+      sums.pressureIntegral = p * dV;
+      sums.maxPressure      = p;
+    }
+
     const auto isNearOutlet = ShapeT::getOutletCoordinate() - i * GpuGridT::hx <= GpuGridT::hx;
-    if (!isInside || !isNearOutlet)
+    if (CellClass::is(cellClass, CellClass::fluid) && isNearOutlet)
     {
-      return ReturnType{};
+      const auto dS = 2 * static_cast<ElemT>(M_PI) * r * GpuGridT::hy;
+      sums.outletArea     = dS;
+      sums.outletVelocity = gasState.ux * dS;
+      sums.outletMassFlow = MassFluxX::get(gasState) * dS;
+      sums.outletPressure = p * dS;
     }
 
-    const auto & gasState = thrust::get<0U>(tuple);
-    const auto dS = 2 * static_cast<ElemT>(M_PI) * r * GpuGridT::hy;
-    const auto dUS = gasState.ux * dS;
-    const auto dG = MassFluxX::get(gasState) * dS;
-    const auto dPS = P::get(gasState) * dS;
-    return ReturnType{ dS, dUS, dG, dPS };
+    return sums;
   };
 
-  const auto sumUp = [] __device__(const ReturnType & lhs, const ReturnType & rhs)
-  {
-    return ReturnType{ thrust::get<0U>(lhs) + thrust::get<0U>(rhs),
-                       thrust::get<1U>(lhs) + thrust::get<1U>(rhs),
-                       thrust::get<2U>(lhs) + thrust::get<2U>(rhs),
-                       thrust::get<3U>(lhs) + thrust::get<3U>(rhs) };
-  };
+  return thrust::transform_reduce(zipFirst, zipLast, toSums, ChamberSums<ElemT>{}, thrust::plus<ChamberSums<ElemT>>{});
+}
 
-  return thrust::transform_reduce(zipFirst, zipLast, toThrust, ReturnType{}, sumUp);
+template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
+ElemT getCalculatedBoriPressure(const thrust::device_vector<GasStateT> &    gasValues,
+                                const thrust::device_vector<std::uint8_t> & cellClasses,
+                                const GeometryPlanes<GpuGridT, ShapeT> &    geometryPlanes)
+{
+  const auto sums = getChamberSums(gasValues, cellClasses, geometryPlanes);
+  return sums.pressureIntegral / sums.volume;
+}
+
+template <class GpuGridT, class ShapeT, class GasStateT, class ElemT>
+IntegralData<ElemT> getIntegralData(const GpuMatrix<GpuGridT, GasStateT> &    gasValues,
+                                    const GpuMatrix<GpuGridT, std::uint8_t> & cellClasses,
+                                    const GeometryPlanes<GpuGridT, ShapeT> &  geometryPlanes,
+                                    ElemT t, ElemT sBurn)
+{
+  const auto sums           = getChamberSums(gasValues.values(), cellClasses.values(), geometryPlanes);
+  const auto meanPressure   = sums.pressureIntegral / sums.volume;
+  const auto massFlowRate   = sums.outletMassFlow;
+  const auto velocity       = sums.outletVelocity / sums.outletArea;
+  const auto thrust         = massFlowRate * velocity + sums.outletPressure;
+  const auto specificThrust = thrust / massFlowRate;
+  return IntegralData<ElemT>{ t, meanPressure, sums.maxPressure, sBurn, thrust, specificThrust, velocity };
 }
 
 } // namespace detail
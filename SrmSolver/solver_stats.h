@@ -0,0 +1,13 @@
+#pragma once
+
+#include "std_includes.h"
+
+namespace kae {
+
+struct SolverStats
+{
+  std::uint64_t massFlowSolveCount{ 0U };
+  std::uint64_t massFlowIterationCount{ 0U };
+};
+
+} // namespace kae
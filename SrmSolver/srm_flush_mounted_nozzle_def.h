@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sdf_cache.h"
+
 namespace kae {
 
 
@@ -49,23 +51,28 @@ SrmFlushMountedNozzle<GpuGridT>::SrmFlushMountedNozzle()
     bg::set<1>(point, bg::get<1>(point) + yBottom);
   });
 
-  Polygon2d polygon;
-  std::copy(std::begin(m_linestring), std::end(m_linestring), std::back_inserter(polygon.outer()));
-
-  for (unsigned i = 0U; i < GpuGridT::nx; ++i)
+  const auto cacheKey = getSdfCacheKey<GpuGridT, SrmFlushMountedNozzle>(
+    m_linestring.data(), m_linestring.size() * sizeof(Point2d), 0U, 0U);
+  loadOrCompute(cacheKey, m_distances.data(), m_distances.size(), [this]()
   {
-    const auto x = i * GpuGridT::hx;
-    for (unsigned j = 0U; j < GpuGridT::ny; ++j)
-    {
-      const auto y = j * GpuGridT::hy;
-      const Point2d point{ x, y };
-      const auto distance = static_cast<ElemType>(bg::distance(point, m_linestring));
-      const auto isInside = bg::covered_by(point, polygon);
+    Polygon2d polygon;
+    std::copy(std::begin(m_linestring), std::end(m_linestring), std::back_inserter(polygon.outer()));
 
-      const auto index = j * GpuGridT::nx + i;
-      m_distances[index] = isInside ? -std::fabs(distance) : std::fabs(distance);
+    for (unsigned i = 0U; i < GpuGridT::nx; ++i)
+    {
+      const auto x = i * GpuGridT::hx;
+      for (unsigned j = 0U; j < GpuGridT::ny; ++j)
+      {
+        const auto y = j * GpuGridT::hy;
+        const Point2d point{ x, y };
+        const auto distance = static_cast<ElemType>(bg::distance(point, m_linestring));
+        const auto isInside = bg::covered_by(point, polygon);
+
+        const auto index = j * GpuGridT::nx + i;
+        m_distances[index] = isInside ? -std::fabs(distance) : std::fabs(distance);
+      }
     }
-  }
+  });
 }
 
 template <class GpuGridT>
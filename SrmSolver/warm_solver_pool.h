@@ -0,0 +1,90 @@
+#pragma once
+
+#include "std_includes.h"
+
+#include "gpu_matrix.h"
+#include "run_description.h"
+#include "shape_solver_types.h"
+
+namespace kae {
+
+namespace detail {
+
+template <class ShapeSolverTypesT>
+struct ShapeSolverKey;
+
+template <EShapeType ShapeType, class ElemT>
+struct ShapeSolverKey<ShapeSolverTypes<ShapeType, ElemT>>
+{
+  constexpr static EShapeType    shape{ ShapeType };
+  constexpr static std::uint32_t elemBytes{ sizeof(ElemT) };
+};
+
+} // namespace detail
+
+// Keeps constructed solvers of one grid type alive between runs. A solver handed back with release() is reset to
+// the initial phi and gas state on the next acquire(), so geometry planes and device workspaces are reused.
+template <class ShapeSolverTypesT>
+class WarmSolverPool
+{
+public:
+
+  using GpuGridType   = typename ShapeSolverTypesT::GpuGridType;
+  using ShapeType     = typename ShapeSolverTypesT::ShapeType;
+  using SrmSolverType = typename ShapeSolverTypesT::SrmSolverType;
+  using ElemType      = typename GpuGridType::ElemType;
+
+  static bool matches(const RunDescription & run)
+  {
+    return (run.shape == detail::ShapeSolverKey<ShapeSolverTypesT>::shape) &&
+           (run.elemBytes == detail::ShapeSolverKey<ShapeSolverTypesT>::elemBytes);
+  }
+
+  std::unique_ptr<SrmSolverType> acquire(const RunDescription & run)
+  {
+    const auto courant = static_cast<ElemType>(run.courant);
+
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    auto & idleSolvers = m_idleSolvers[getKey(run)];
+    if (!idleSolvers.empty())
+    {
+      auto pSolver = std::move(idleSolvers.back());
+      idleSolvers.pop_back();
+      const auto & initialPhi = m_initialPhis.at(run.reinitializeIterationCount);
+      lock.unlock();
+
+      pSolver->reset(initialPhi, ShapeSolverTypesT::initialGasState, courant);
+      return pSolver;
+    }
+
+    lock.unlock();
+    auto pSolver = std::make_unique<SrmSolverType>(ShapeType{}, ShapeSolverTypesT::initialGasState,
+                                                   run.reinitializeIterationCount, courant, run.fluxSweep);
+    lock.lock();
+    m_initialPhis.emplace(run.reinitializeIterationCount, pSolver->currPhi());
+    return pSolver;
+  }
+
+  void release(const RunDescription & run, std::unique_ptr<SrmSolverType> pSolver)
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_idleSolvers[getKey(run)].push_back(std::move(pSolver));
+  }
+
+private:
+
+  using KeyType = std::pair<unsigned, EFluxSweep>;
+
+  static KeyType getKey(const RunDescription & run)
+  {
+    return { run.reinitializeIterationCount, run.fluxSweep };
+  }
+
+private:
+
+  std::mutex                                                     m_mutex;
+  std::map<unsigned, GpuMatrix<GpuGridType, ElemType>>           m_initialPhis;
+  std::map<KeyType, std::vector<std::unique_ptr<SrmSolverType>>> m_idleSolvers;
+};
+
+} // namespace kae
@@ -18,6 +18,8 @@ using GasStateType = kae::GasState<GasStateProperties<KappaT, RT, ElemT>, ElemT>
 template <class NuT, class MtT, class TBurnT, class RhoPT, class P0T, class KappaT, class CpT, class ElemT>
 struct PhysicalProperties
 {
+  using NuType = NuT;
+
   constexpr static ElemT kappa = kae::detail::ToFloatV<KappaT, ElemT>;
   constexpr static ElemT nu    = kae::detail::ToFloatV<NuT, ElemT>;
   constexpr static ElemT mt    = kae::detail::ToFloatV<MtT, ElemT>;
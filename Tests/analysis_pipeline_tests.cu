@@ -0,0 +1,272 @@
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/analysis_pipeline.h>
+#include <SrmSolver/empty_callback.h>
+#include <SrmSolver/gpu_derived_fields_kernel.h>
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/gpu_srm_solver.h>
+#include <SrmSolver/physical_properties.h>
+
+#include "aliases.h"
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+template <class GpuGridT, class GasStateT>
+struct VaryingGasState
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE GasStateT operator()(unsigned i, unsigned j) const
+  {
+    const ElemType x = i * GpuGridT::hx;
+    const ElemType y = j * GpuGridT::hy;
+    return GasStateT{ 1 + x, x - y, y, 2 + y };
+  }
+};
+
+// Axisymmetric channel open at the right end. The grain covers the lateral wall away from both ends.
+template <class GpuGridT>
+class BurningChannel
+{
+public:
+
+  using ElemType = typename GpuGridT::ElemType;
+
+  constexpr static ElemType xLeft{ static_cast<ElemType>(0.5) };
+  constexpr static ElemType xRight{ static_cast<ElemType>(3.5) };
+  constexpr static ElemType yBottom{ static_cast<ElemType>(5.5) * GpuGridT::hy };
+  constexpr static ElemType radius{ static_cast<ElemType>(1.0) };
+  constexpr static ElemType xGrainLeft{ xLeft + static_cast<ElemType>(0.25) };
+  constexpr static ElemType xGrainRight{ xRight - static_cast<ElemType>(0.25) };
+
+  HOST_DEVICE ElemType operator()(unsigned i, unsigned j) const
+  {
+    const ElemType dx = thrust::max(xLeft - i * GpuGridT::hx, i * GpuGridT::hx - xRight);
+    const ElemType dy = thrust::max(yBottom - j * GpuGridT::hy, j * GpuGridT::hy - yBottom - radius);
+    const ElemType outside = std::hypot(thrust::max(dx, static_cast<ElemType>(0)),
+                                        thrust::max(dy, static_cast<ElemType>(0)));
+    return outside + thrust::min(thrust::max(dx, dy), static_cast<ElemType>(0));
+  }
+
+  HOST_DEVICE static bool shouldApplyScheme(unsigned, unsigned) { return true; }
+
+  HOST_DEVICE static bool isChamber(ElemType x, ElemType)
+  {
+    return (xRight - x >= static_cast<ElemType>(0.1) * GpuGridT::hx) &&
+           (x - xLeft >= static_cast<ElemType>(0.1) * GpuGridT::hx);
+  }
+
+  HOST_DEVICE static bool isBurningSurface(ElemType x, ElemType y)
+  {
+    return (xGrainRight - x >= static_cast<ElemType>(-0.1) * GpuGridT::hx) &&
+           (x - xGrainLeft >= static_cast<ElemType>(-0.1) * GpuGridT::hx) &&
+           (y - yBottom >= static_cast<ElemType>(0.5) * radius);
+  }
+
+  HOST_DEVICE static bool isPointOnGrain(ElemType x, ElemType y) { return isBurningSurface(x, y); }
+
+  HOST_DEVICE static kae::EBoundaryCondition getBoundaryCondition(ElemType x, ElemType y)
+  {
+    if (std::fabs(x - xRight) < static_cast<ElemType>(0.1) * GpuGridT::hx)
+    {
+      return kae::EBoundaryCondition::ePressureOutlet;
+    }
+
+    return isPointOnGrain(x, y) ? kae::EBoundaryCondition::eMassFlowInlet : kae::EBoundaryCondition::eWall;
+  }
+
+  HOST_DEVICE static ElemType getRadius(unsigned, unsigned j) { return j * GpuGridT::hy - yBottom; }
+  HOST_DEVICE static ElemType getRadius(ElemType, ElemType y) { return y - yBottom; }
+
+  constexpr HOST_DEVICE static ElemType getInitialSBurn()
+  {
+    return 2 * static_cast<ElemType>(M_PI) * radius * (xGrainRight - xGrainLeft);
+  }
+
+  constexpr HOST_DEVICE static ElemType getFCritical() { return static_cast<ElemType>(M_PI) * radius * radius; }
+  constexpr HOST_DEVICE static ElemType getOutletCoordinate() { return xRight; }
+};
+
+// Declares its quantities, so it is subscribed without naming them.
+template <class FrameT>
+struct RecordingPlugin
+{
+  std::uint32_t quantities() const { return kae::AnalysisQuantity::mach; }
+
+  void operator()(const FrameT & frame) const
+  {
+    pFrames->push_back(frame.iteration);
+    EXPECT_NE(frame.pMach, nullptr);
+  }
+
+  std::vector<unsigned> * pFrames;
+};
+
+template <class T>
+class analysis_pipeline : public ::testing::Test
+{
+public:
+
+  constexpr static unsigned nx{ 40U };
+  constexpr static unsigned ny{ 20U };
+  using ElemType    = T;
+  using LxToType    = std::ratio<4, 1>;
+  using LyToType    = std::ratio<2, 1>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, 3U, ElemType>;
+  using GasStateT   = GasStateType<std::ratio<12, 10>, std::ratio<6, 1>, ElemType>;
+
+  constexpr static unsigned solverNx{ 81U };
+  constexpr static unsigned solverNy{ 41U };
+  using SolverGridType = kae::GpuGrid<solverNx, solverNy, std::ratio<4, 1>, std::ratio<2, 1>, 3U, ElemType>;
+  using ShapeType      = BurningChannel<SolverGridType>;
+  using PhysicalPropertiesType = kae::PhysicalProperties<std::ratio<41, 100>, std::ratio<-96446, 1000000>,
+                                                         std::ratio<2950, 1>, std::ratio<1700, 1>,
+                                                         std::ratio<101325, 1>, std::ratio<123, 100>,
+                                                         std::ratio<1800, 1>, ShapeType>;
+  using SolverGasStateType = kae::GasState<PhysicalPropertiesType, ElemType>;
+  using SrmSolverType      = kae::GpuSrmSolver<SolverGridType, ShapeType, SolverGasStateType, PhysicalPropertiesType>;
+};
+
+using TypeParams = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(analysis_pipeline, TypeParams);
+
+TYPED_TEST(analysis_pipeline, analysis_pipeline_cadence)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using GasStateT = typename tf::GasStateT;
+  using PipelineT = kae::AnalysisPipeline<GpuGridT, GasStateT>;
+
+  static_assert(kae::detail::IsAnalysisPipelineV<PipelineT &>, "Pipeline must be detected");
+  static_assert(!kae::detail::IsAnalysisPipelineV<kae::detail::EmptyCallback>, "Callbacks must not be detected");
+
+  PipelineT pipeline;
+  EXPECT_FALSE(pipeline.isDue(0U));
+
+  std::vector<unsigned> integralFrames;
+  std::vector<unsigned> machFrames;
+  pipeline.subscribe(kae::AnalysisQuantity::integrals, 10U,
+                     [&integralFrames](const auto & frame) { integralFrames.push_back(frame.iteration); });
+  pipeline.subscribe(kae::AnalysisQuantity::mach | kae::AnalysisQuantity::maxDerivatives, 25U,
+                     [&machFrames](const auto & frame) { machFrames.push_back(frame.iteration); });
+
+  EXPECT_TRUE(pipeline.isDue(0U));
+  EXPECT_FALSE(pipeline.isDue(5U));
+  EXPECT_EQ(pipeline.getRequiredQuantities(5U), 0U);
+  EXPECT_EQ(pipeline.getRequiredQuantities(20U), kae::AnalysisQuantity::integrals);
+  EXPECT_EQ(pipeline.getRequiredQuantities(25U), kae::AnalysisQuantity::mach | kae::AnalysisQuantity::maxDerivatives);
+  EXPECT_EQ(pipeline.getRequiredQuantities(50U),
+            kae::AnalysisQuantity::integrals | kae::AnalysisQuantity::mach | kae::AnalysisQuantity::maxDerivatives);
+
+  const kae::GpuMatrix<GpuGridT, GasStateT> gasValues{ VaryingGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> currPhi{ static_cast<ElemT>(-1) };
+  for (unsigned i{ 0U }; i <= 50U; ++i)
+  {
+    if (pipeline.isDue(i))
+    {
+      pipeline(kae::AnalysisFrame<GpuGridT, GasStateT>{ i, static_cast<ElemT>(i), gasValues, currPhi });
+    }
+  }
+  static_assert(kae::detail::IsEmptyCallbackV<decltype(kae::detail::getInnerCallback(pipeline))>,
+                "Inner iterations must not reach the pipeline");
+
+  EXPECT_EQ(integralFrames, (std::vector<unsigned>{ 0U, 10U, 20U, 30U, 40U, 50U }));
+  EXPECT_EQ(machFrames, (std::vector<unsigned>{ 0U, 25U, 50U }));
+}
+
+TYPED_TEST(analysis_pipeline, analysis_pipeline_derived_fields)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using GasStateT = typename tf::GasStateT;
+
+  const kae::GpuMatrix<GpuGridT, GasStateT> gasValues{ VaryingGasState<GpuGridT, GasStateT>{} };
+  kae::GpuMatrix<GpuGridT, ElemT> mach{ static_cast<ElemT>(0) };
+  kae::GpuMatrix<GpuGridT, ElemT> temperature{ static_cast<ElemT>(0) };
+
+  kae::detail::calculateDerivedFieldsWrapper<GpuGridT>(getConstDevicePtr(gasValues), getDevicePtr(mach),
+                                                       getDevicePtr(temperature));
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<GasStateT> hostGasValues = gasValues.values();
+  const thrust::host_vector<ElemT> hostMach = mach.values();
+  const thrust::host_vector<ElemT> hostTemperature = temperature.values();
+  const ElemT threshold = 10 * std::numeric_limits<ElemT>::epsilon();
+  for (unsigned idx{ 0U }; idx < GpuGridT::n; ++idx)
+  {
+    EXPECT_NEAR(hostMach[idx], kae::Mach::get(hostGasValues[idx]), threshold);
+    EXPECT_NEAR(hostTemperature[idx], kae::Temperature::get(hostGasValues[idx]),
+                threshold * kae::Temperature::get(hostGasValues[idx]));
+  }
+}
+
+TYPED_TEST(analysis_pipeline, analysis_pipeline_srm_solver)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::SolverGridType;
+  using ShapeT    = typename tf::ShapeType;
+  using GasStateT = typename tf::SolverGasStateType;
+  using PipelineT = kae::AnalysisPipeline<GpuGridT, GasStateT>;
+  using FrameT    = typename PipelineT::FrameType;
+
+  const GasStateT initialState{ 1, 0, 0, tf::PhysicalPropertiesType::P0 };
+  typename tf::SrmSolverType solver{ ShapeT{}, initialState };
+
+  std::vector<unsigned> integralFrames;
+  std::vector<unsigned> machFrames;
+  PipelineT pipeline;
+  pipeline.subscribe(kae::AnalysisQuantity::integrals, 2U, [&integralFrames](const FrameT & frame)
+  {
+    integralFrames.push_back(frame.iteration);
+    ASSERT_TRUE(frame.integrals);
+    ASSERT_TRUE(frame.sBurn);
+    EXPECT_EQ(std::get<3U>(*frame.integrals), *frame.sBurn);
+    EXPECT_NEAR(*frame.sBurn, ShapeT::getInitialSBurn(), static_cast<ElemT>(0.05) * ShapeT::getInitialSBurn());
+
+    // The fused pass must agree with the chamber integrals gathered cell by cell from the same classification.
+    const thrust::host_vector<GasStateT> gasValues = frame.gasValues.values();
+    const thrust::host_vector<ElemT> phiValues = frame.currPhi.values();
+    double volume{ 0.0 };
+    double pressureIntegral{ 0.0 };
+    ElemT maxPressure{ 0 };
+    for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+    {
+      for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+      {
+        const auto index = j * GpuGridT::nx + i;
+        const auto cellClass = static_cast<std::uint8_t>(
+          kae::CellClass::get<GpuGridT>(phiValues[index]) |
+          (ShapeT::isChamber(i * GpuGridT::hx, j * GpuGridT::hy) ? 0U : kae::CellClass::outsideChamber));
+        if (!kae::detail::CellClassIsChamberFluid{}(cellClass))
+        {
+          continue;
+        }
+
+        const auto p = kae::P::get(gasValues[index]);
+        const auto r = kae::detail::RadiusInitializer<GpuGridT, ShapeT>{}(i, j);
+        volume           += r;
+        pressureIntegral += r * p;
+        maxPressure       = std::max(maxPressure, p);
+      }
+    }
+
+    EXPECT_NEAR(std::get<1U>(*frame.integrals), pressureIntegral / volume, 1e-4 * pressureIntegral / volume);
+    EXPECT_NEAR(std::get<2U>(*frame.integrals), maxPressure, 10 * std::numeric_limits<ElemT>::epsilon() * maxPressure);
+  });
+  pipeline.subscribe(3U, RecordingPlugin<FrameT>{ &machFrames });
+
+  solver.staticIntegrate(7U, kae::ETimeDiscretizationOrder::eTwo, pipeline);
+
+  EXPECT_EQ(integralFrames, (std::vector<unsigned>{ 0U, 2U, 4U, 6U }));
+  EXPECT_EQ(machFrames, (std::vector<unsigned>{ 0U, 3U, 6U }));
+}
+
+} // namespace kae_tests
+
+#endif
@@ -0,0 +1,110 @@
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/burn_back_ballistics_solver.h>
+
+namespace kae_tests {
+
+namespace {
+
+struct BallisticsShape
+{
+  using ElemType = double;
+
+  constexpr static ElemType getFCritical() { return 1.0; }
+};
+
+struct BallisticsProperties
+{
+  using NuType = std::ratio<1, 2>;
+
+  constexpr static double kappa        = 1.2;
+  constexpr static double gammaComplex = 0.648531;
+  constexpr static double nu           = kae::detail::ToFloatV<NuType, double>;
+  constexpr static double mt           = -1.0;
+  constexpr static double rhoP         = 100.0;
+  constexpr static double P0           = 0.01;
+  constexpr static double H0           = kappa / (kappa - 1);
+};
+
+using SolverType = kae::BurnBackBallisticsSolver<BallisticsShape, BallisticsProperties>;
+
+kae::BurnBackTable<double> getConstantTable(double maxWeb)
+{
+  kae::BurnBackTable<double> table;
+  constexpr unsigned webCount{ 11U };
+  for (unsigned idx{ 0U }; idx < webCount; ++idx)
+  {
+    table.webs.push_back(maxWeb * idx / (webCount - 1U));
+    table.burningSurfaces.push_back(1.0);
+    table.chamberVolumes.push_back(1.0);
+  }
+  return table;
+}
+
+} // namespace
+
+TEST(burn_back_ballistics_solver, burn_back_ballistics_solver_reaches_equilibrium)
+{
+  const SolverType solver{ getConstantTable(10.0) };
+  const auto values = solver.integrate(50.0);
+
+  ASSERT_FALSE(values.empty());
+  EXPECT_EQ(std::get<0U>(values.front()), 0.0);
+  EXPECT_DOUBLE_EQ(std::get<0U>(values.back()), 50.0);
+
+  const auto equilibriumPressure = solver.getEquilibriumPressure(0.0);
+  EXPECT_NEAR(std::get<1U>(values.back()), equilibriumPressure, 1e-3 * equilibriumPressure);
+  EXPECT_EQ(std::get<1U>(values.back()), std::get<2U>(values.back()));
+  EXPECT_EQ(std::get<3U>(values.back()), 1.0);
+}
+
+TEST(burn_back_ballistics_solver, burn_back_ballistics_solver_stops_after_burnout)
+{
+  const SolverType solver{ getConstantTable(0.2) };
+  const auto values = solver.integrate(1000.0);
+
+  ASSERT_FALSE(values.empty());
+  EXPECT_LT(std::get<0U>(values.back()), 1000.0);
+  EXPECT_LE(std::get<1U>(values.back()), BallisticsProperties::P0);
+  EXPECT_EQ(std::get<3U>(values.back()), 0.0);
+  for (std::size_t idx{ 1U }; idx < values.size(); ++idx)
+  {
+    EXPECT_GT(std::get<0U>(values[idx]), std::get<0U>(values[idx - 1U]));
+  }
+}
+
+TEST(burn_back_ballistics_solver, burn_back_ballistics_solver_rejects_inconsistent_table)
+{
+  auto table = getConstantTable(1.0);
+  table.chamberVolumes.pop_back();
+  EXPECT_THROW(SolverType{ table }, std::invalid_argument);
+  EXPECT_THROW(SolverType{ kae::BurnBackTable<double>{} }, std::invalid_argument);
+}
+
+TEST(burn_back_ballistics_solver, burn_back_ballistics_solver_writes_mean_pressure_columns)
+{
+  const SolverType solver{ getConstantTable(1.0) };
+  const auto values = solver.integrate(1.0);
+
+  std::ostringstream stream;
+  kae::writeIntegralData(stream, values);
+
+  std::istringstream lines{ stream.str() };
+  std::string header;
+  std::getline(lines, header);
+  EXPECT_EQ(header, "t;P_av;P_max;S;Thrust;specThrust;velocity");
+
+  std::string line;
+  std::size_t lineCount{ 0U };
+  while (std::getline(lines, line))
+  {
+    EXPECT_EQ(std::count(std::begin(line), std::end(line), ';'), 6);
+    ++lineCount;
+  }
+  EXPECT_EQ(lineCount, values.size());
+}
+
+} // namespace kae_tests
@@ -56,6 +56,35 @@ public:
       << diffMatrix << "\n\n";
   }
 
+  void testCachedPseudoInverse()
+  {
+    using kae::detail::getStencilIndices;
+
+    using tf = extrapolate_polynomial_tests<T>;
+    using ElemType = typename tf::ElemType;
+    using GpuGridType = typename tf::GpuGridType;
+
+    const auto negativeValue = static_cast<ElemType>(-0.1);
+    std::vector<ElemType> phiValues(GpuGridType::nx * GpuGridType::ny, negativeValue);
+    const auto gasStates = this->generateGasStates();
+    const auto pGasValues = gasStates.data();
+
+    const auto indexMatrix = getStencilIndices<GpuGridType, tf::order>(phiValues.data(), tf::surfacePoint, tf::normal);
+    const auto pseudoInverse = kae::detail::getPseudoInverse<GpuGridType>(tf::surfacePoint, tf::normal, indexMatrix);
+    const auto coefficients = kae::detail::getWenoPolynomial<GpuGridType>(tf::surfacePoint,
+      tf::normal,
+      pGasValues,
+      indexMatrix);
+    const auto cachedCoefficients = kae::detail::getCachedWenoPolynomial<GpuGridType>(tf::surfacePoint,
+      tf::normal,
+      pseudoInverse,
+      pGasValues,
+      indexMatrix);
+
+    const auto maxDiff = maxCoeff(cwiseAbs(coefficients - cachedCoefficients));
+    EXPECT_LE(maxDiff, tf::cachedThreshold) << coefficients << "\n\n" << cachedCoefficients << "\n\n";
+  }
+
 private:
 
   constexpr static unsigned order{ 2U };
@@ -110,6 +139,9 @@ private:
     -std::get<2U>(uCoeffs) * normal.y + std::get<2U>(vCoeffs) * normal.x
   };
 
+  constexpr static ElemType cachedThreshold{ std::is_same<ElemType, float>::value ? static_cast<ElemType>(1e-3) :
+                                                                                   static_cast<ElemType>(1e-10) };
+
   constexpr static ElemType multiplier{ static_cast<ElemType>(5.0) };
   constexpr static std::array<ElemType, nCoefficients> thresholdVector{
     multiplier * hx * hx, multiplier * hx, multiplier * hy
@@ -170,4 +202,9 @@ TYPED_TEST(extrapolate_polynomial_tests, extrapolate_polynomial_tests_1)
   this->test();
 }
 
+TYPED_TEST(extrapolate_polynomial_tests, extrapolate_polynomial_cached_pseudo_inverse)
+{
+  this->testCachedPseudoInverse();
+}
+
 } // namespace kae_tests
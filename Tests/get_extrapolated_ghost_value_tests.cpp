@@ -121,4 +121,41 @@ TYPED_TEST(get_extrapolated_ghost_value, get_extrapolated_ghost_value_massflow_i
   EXPECT_GAS_STATE_NEAR(extrapolatedState, goldExtrapolatedState, threshold);
 }
 
+TYPED_TEST(get_extrapolated_ghost_value, get_extrapolated_ghost_value_massflow_inlet_warm_start)
+{
+  using ElemType = typename TestFixture::ElemType;
+  using GasStateType = typename TestFixture::GasStateType;
+  using PhysicalPropertiesType = typename TestFixture::PhysicalPropertiesType;
+
+  const GasStateType gasState{ static_cast<ElemType>(1.0),
+                               static_cast<ElemType>(-0.3),
+                               static_cast<ElemType>(0.1),
+                               static_cast<ElemType>(1.0) };
+  ElemType p1{ 0 };
+  unsigned coldIterationCount{ 0U };
+  const auto coldState = kae::detail::getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesType>(
+    gasState, gasState, p1, coldIterationCount);
+
+  const GasStateType perturbedGasState{ static_cast<ElemType>(1.0),
+                                        static_cast<ElemType>(-0.3),
+                                        static_cast<ElemType>(0.1),
+                                        static_cast<ElemType>(1.001) };
+  unsigned warmIterationCount{ 0U };
+  const auto warmState = kae::detail::getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesType>(
+    perturbedGasState, perturbedGasState, p1, warmIterationCount);
+  const auto goldWarmState = kae::detail::getFirstOrderMassFlowExtrapolatedGhostValue<PhysicalPropertiesType>(
+    perturbedGasState, perturbedGasState);
+
+  EXPECT_GT(coldIterationCount, 2U);
+  EXPECT_LE(warmIterationCount, 2U);
+  EXPECT_FLOAT_EQ(p1, warmState.p);
+  constexpr ElemType threshold{ std::is_same<ElemType, float>::value ? static_cast<ElemType>(1e-5) :
+                                                                       static_cast<ElemType>(1e-12) };
+  EXPECT_GAS_STATE_NEAR(warmState, goldWarmState, threshold);
+  EXPECT_GAS_STATE_NEAR(coldState, (GasStateType{ static_cast<ElemType>(1.0),
+                                                  static_cast<ElemType>(-0.3),
+                                                  static_cast<ElemType>(0.0),
+                                                  static_cast<ElemType>(1.0) }), threshold);
+}
+
 } // namespace kae_tests
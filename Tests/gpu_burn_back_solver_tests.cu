@@ -0,0 +1,126 @@
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/gpu_burn_back_solver.h>
+#include <SrmSolver/gpu_grid.h>
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+template <class GpuGridT>
+class RadialBurningTube
+{
+public:
+
+  using ElemType = typename GpuGridT::ElemType;
+
+  constexpr static ElemType xLeft{ static_cast<ElemType>(0.5) };
+  constexpr static ElemType xRight{ static_cast<ElemType>(3.5) };
+  constexpr static ElemType innerRadius{ static_cast<ElemType>(1.0) };
+  constexpr static ElemType outerRadius{ static_cast<ElemType>(2.0) };
+
+  HOST_DEVICE ElemType operator()(unsigned, unsigned j) const
+  {
+    return j * GpuGridT::hy - innerRadius;
+  }
+
+  HOST_DEVICE static bool isChamber(ElemType x, ElemType)
+  {
+    return (x >= xLeft) && (x <= xRight);
+  }
+
+  HOST_DEVICE static bool isBurningSurface(ElemType x, ElemType y)
+  {
+    return isChamber(x, y) && (y >= innerRadius - GpuGridT::hy) && (y <= outerRadius);
+  }
+
+  HOST_DEVICE static bool isPointOnGrain(ElemType x, ElemType y) { return isBurningSurface(x, y); }
+
+  HOST_DEVICE static ElemType getRadius(unsigned, unsigned j) { return j * GpuGridT::hy; }
+};
+
+template <class T>
+class gpu_burn_back_solver : public ::testing::Test
+{
+public:
+
+  constexpr static unsigned nx{ 201U };
+  constexpr static unsigned ny{ 201U };
+  using ElemType    = T;
+  using LxToType    = std::ratio<4, 1>;
+  using LyToType    = std::ratio<4, 1>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, 3U, ElemType>;
+  using ShapeType   = RadialBurningTube<GpuGridType>;
+};
+
+using TypeParams = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(gpu_burn_back_solver, TypeParams);
+
+TYPED_TEST(gpu_burn_back_solver, gpu_burn_back_solver_arrival_times)
+{
+  using tf       = TestFixture;
+  using ElemT    = typename tf::ElemType;
+  using GpuGridT = typename tf::GpuGridType;
+  using ShapeT   = typename tf::ShapeType;
+
+  const kae::GpuBurnBackSolver<GpuGridT, ShapeT> solver;
+  const thrust::host_vector<ElemT> arrivalTimes = solver.arrivalTimes().values();
+
+  const ElemT threshold = GpuGridT::hx / 10;
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    for (unsigned i{ 1U }; i + 1U < GpuGridT::nx; ++i)
+    {
+      const ElemT x = i * GpuGridT::hx;
+      const ElemT y = j * GpuGridT::hy;
+      if ((y > ShapeT::innerRadius) && ShapeT::isBurningSurface(x, y))
+      {
+        EXPECT_NEAR(arrivalTimes[j * GpuGridT::nx + i], y - ShapeT::innerRadius, threshold);
+      }
+    }
+  }
+
+  EXPECT_NEAR(solver.getMaxWeb(), ShapeT::outerRadius - ShapeT::innerRadius, GpuGridT::hy);
+}
+
+TYPED_TEST(gpu_burn_back_solver, gpu_burn_back_solver_table)
+{
+  using tf       = TestFixture;
+  using ElemT    = typename tf::ElemType;
+  using GpuGridT = typename tf::GpuGridType;
+  using ShapeT   = typename tf::ShapeType;
+
+  const kae::GpuBurnBackSolver<GpuGridT, ShapeT> solver;
+  const auto table = solver.getTable(2 * GpuGridT::hy);
+
+  ASSERT_FALSE(table.webs.empty());
+  ASSERT_EQ(table.webs.size(), table.burningSurfaces.size());
+  ASSERT_EQ(table.webs.size(), table.chamberVolumes.size());
+  ASSERT_EQ(table.webs.size(), table.portAreas.size());
+  EXPECT_EQ(table.webs.front(), static_cast<ElemT>(0));
+  EXPECT_EQ(table.webs.back(), solver.getMaxWeb());
+
+  constexpr auto pi        = static_cast<ElemT>(M_PI);
+  constexpr auto length    = ShapeT::xRight - ShapeT::xLeft;
+  constexpr auto middle    = static_cast<unsigned>((ShapeT::xLeft + ShapeT::xRight) / 2 / GpuGridT::hx);
+  constexpr auto tolerance = static_cast<ElemT>(0.05);
+
+  for (std::size_t idx{ 0U }; idx < table.webs.size(); ++idx)
+  {
+    const auto web    = table.webs[idx];
+    const auto radius = ShapeT::innerRadius + web;
+    EXPECT_NEAR(table.chamberVolumes[idx], pi * radius * radius * length, tolerance * pi * radius * radius * length);
+    EXPECT_NEAR(table.portAreas[idx][middle], pi * radius * radius, tolerance * pi * radius * radius);
+    EXPECT_NEAR(table.burningSurfaces[idx], 2 * pi * radius * length, tolerance * 2 * pi * radius * length);
+
+    if (idx > 0U)
+    {
+      EXPECT_GE(table.chamberVolumes[idx], table.chamberVolumes[idx - 1U]);
+    }
+  }
+}
+
+} // namespace kae_tests
+
+#endif
@@ -0,0 +1,216 @@
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/cell_class.h>
+#include <SrmSolver/gpu_extend_burning_rates_kernel.h>
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/gpu_matrix.h>
+
+#include "aliases.h"
+#include "shapes.h"
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+template <class GpuGridT>
+struct CircleLevel
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE ElemType operator()(unsigned i, unsigned j) const
+  {
+    return CircleShape<GpuGridT>::reinitializedValue(i, j);
+  }
+};
+
+template <class GpuGridT>
+struct CircleNormal
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE kae::CudaFloat2T<ElemType> operator()(unsigned i, unsigned j) const
+  {
+    const ElemType x = i * GpuGridT::hx - CircleShape<GpuGridT>::offset;
+    const ElemType y = j * GpuGridT::hy - CircleShape<GpuGridT>::offset;
+    const ElemType length = std::hypot(x, y);
+    return { x / length, y / length };
+  }
+};
+
+template <class GpuGridT>
+struct CircleClasses
+{
+  HOST_DEVICE std::uint8_t operator()(unsigned i, unsigned j) const
+  {
+    const auto level = CircleLevel<GpuGridT>{}(i, j);
+    const bool isGhost = (level >= 0) && (level < 5 * GpuGridT::hx);
+    return static_cast<std::uint8_t>(kae::CellClass::get<GpuGridT>(level) |
+      (isGhost ? kae::CellClass::getGhost(kae::EBoundaryCondition::eMassFlowInlet) : std::uint8_t{ 0U }));
+  }
+};
+
+template <class GpuGridT>
+struct AngularFrontRate
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE static ElemType get(unsigned i, unsigned j)
+  {
+    const ElemType x = i * GpuGridT::hx - CircleShape<GpuGridT>::offset;
+    const ElemType y = j * GpuGridT::hy - CircleShape<GpuGridT>::offset;
+    return 1 + static_cast<ElemType>(0.5) * std::sin(std::atan2(y, x));
+  }
+
+  HOST_DEVICE ElemType operator()(unsigned i, unsigned j) const
+  {
+    return get(i, j);
+  }
+};
+
+template <class GpuGridT>
+struct HalfPlaneGrain
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  constexpr static ElemType xGrain{ static_cast<ElemType>(2.0) };
+
+  HOST_DEVICE static bool isPointOnGrain(ElemType x, ElemType) { return x < xGrain; }
+};
+
+template <class GpuGridT, class GasStateT>
+struct IndexedPressureState
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE GasStateT operator()(unsigned i, unsigned j) const
+  {
+    return GasStateT{ 1, 0, 0, static_cast<ElemType>(1 + j * GpuGridT::nx + i) / GpuGridT::n };
+  }
+};
+
+template <class T>
+class gpu_extend_burning_rates : public ::testing::Test
+{
+public:
+
+  constexpr static unsigned nx{ 100U };
+  constexpr static unsigned ny{ 100U };
+  using ElemType    = T;
+  using LxToType    = std::ratio<4, 1>;
+  using LyToType    = std::ratio<4, 1>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, 3U, ElemType>;
+  using KappaType   = std::ratio<12, 10>;
+  using CpType      = std::ratio<6045, 1000>;
+  using GasStateT   = GasStateType<KappaType, CpType, ElemType>;
+  using PhysicalPropertiesType = PhysicalProperties<std::ratio<5, 10>, std::ratio<-3, 10>, std::ratio<1, 1>,
+                                                    std::ratio<300, 1>, std::ratio<144, 1000>, KappaType, CpType,
+                                                    ElemType>;
+};
+
+using TypeParams = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(gpu_extend_burning_rates, TypeParams);
+
+TYPED_TEST(gpu_extend_burning_rates, gpu_extend_burning_rates_constant_along_normals)
+{
+  using tf       = TestFixture;
+  using ElemT    = typename tf::ElemType;
+  using GpuGridT = typename tf::GpuGridType;
+
+  const kae::GpuMatrix<GpuGridT, ElemT> currPhi{ CircleLevel<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, kae::CudaFloat2T<ElemT>> normals{ CircleNormal<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ CircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> frontRates{ AngularFrontRate<GpuGridT>{} };
+  kae::GpuMatrix<GpuGridT, ElemT> burningRates{ static_cast<ElemT>(-1.0) };
+
+  kae::detail::extendBurningRates<GpuGridT><<<GpuGridT::gridSize, GpuGridT::blockSize>>>(
+    getConstDevicePtr(currPhi).get(), getConstDevicePtr(normals).get(), getConstDevicePtr(cellClasses).get(),
+    getConstDevicePtr(frontRates).get(), getDevicePtr(burningRates).get());
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<ElemT> phiValues  = currPhi.values();
+  const thrust::host_vector<ElemT> rateValues = burningRates.values();
+  const ElemT threshold = 2 * GpuGridT::hx;
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+    {
+      const unsigned index = j * GpuGridT::nx + i;
+      if (std::fabs(phiValues[index]) >= 10 * GpuGridT::hx)
+      {
+        EXPECT_EQ(rateValues[index], static_cast<ElemT>(0.0));
+      }
+      else
+      {
+        EXPECT_NEAR(rateValues[index], AngularFrontRate<GpuGridT>::get(i, j), threshold);
+      }
+    }
+  }
+}
+
+TYPED_TEST(gpu_extend_burning_rates, gpu_extend_burning_rates_front_rates)
+{
+  using tf                  = TestFixture;
+  using ElemT               = typename tf::ElemType;
+  using GpuGridT            = typename tf::GpuGridType;
+  using GasStateT           = typename tf::GasStateT;
+  using PhysicalPropertiesT = typename tf::PhysicalPropertiesType;
+  using ShapeT              = HalfPlaneGrain<GpuGridT>;
+  using IndexPairT          = thrust::pair<unsigned, unsigned>;
+
+  // Each ghost reads a state several cells away, alternating surface points on and off the grain.
+  constexpr unsigned ghostCount{ 16U };
+  std::vector<IndexPairT> hostIndicesMap;
+  std::vector<kae::CudaFloat2T<ElemT>> hostSurfacePoints;
+  for (unsigned ghostSlot{ 0U }; ghostSlot < ghostCount; ++ghostSlot)
+  {
+    const unsigned ghostIdx   = (10U + 4U * ghostSlot) * GpuGridT::nx + 50U;
+    const unsigned closestIdx = ghostIdx + 3U * GpuGridT::nx + 2U;
+    const ElemT    xSurface   = (ghostSlot % 2U == 0U) ? ShapeT::xGrain / 2 : 3 * ShapeT::xGrain / 2;
+    hostIndicesMap.push_back(IndexPairT{ ghostIdx, closestIdx });
+    hostSurfacePoints.push_back(kae::CudaFloat2T<ElemT>{ xSurface, static_cast<ElemT>(1.0) });
+  }
+
+  const kae::GpuMatrix<GpuGridT, GasStateT> gasValues{ IndexedPressureState<GpuGridT, GasStateT>{} };
+  const thrust::device_vector<IndexPairT> indicesMap(std::begin(hostIndicesMap), std::end(hostIndicesMap));
+  const thrust::device_vector<kae::CudaFloat2T<ElemT>> surfacePoints(std::begin(hostSurfacePoints),
+                                                                     std::end(hostSurfacePoints));
+  const auto sentinel = static_cast<ElemT>(-1.0);
+  kae::GpuMatrix<GpuGridT, ElemT> frontRates{ sentinel };
+
+  kae::detail::calculateFrontBurningRates<GpuGridT, ShapeT, PhysicalPropertiesT><<<1U, 64U>>>(
+    getConstDevicePtr(gasValues).get(), indicesMap.data().get(), surfacePoints.data().get(),
+    getDevicePtr(frontRates).get(), ghostCount);
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<GasStateT> hostGasValues = gasValues.values();
+  const thrust::host_vector<ElemT> rateValues = frontRates.values();
+  std::vector<bool> isGhost(GpuGridT::n, false);
+  for (unsigned ghostSlot{ 0U }; ghostSlot < ghostCount; ++ghostSlot)
+  {
+    const auto indexMap = hostIndicesMap[ghostSlot];
+    isGhost[indexMap.first] = true;
+    if (!ShapeT::isPointOnGrain(hostSurfacePoints[ghostSlot].x, hostSurfacePoints[ghostSlot].y))
+    {
+      EXPECT_EQ(rateValues[indexMap.first], static_cast<ElemT>(0.0));
+      continue;
+    }
+
+    const auto expected = kae::BurningRate<PhysicalPropertiesT>{}(hostGasValues[indexMap.second]);
+    const auto ghostOwnRate = kae::BurningRate<PhysicalPropertiesT>{}(hostGasValues[indexMap.first]);
+    EXPECT_NEAR(rateValues[indexMap.first], expected, 10 * std::numeric_limits<ElemT>::epsilon() * std::fabs(expected));
+    EXPECT_NE(rateValues[indexMap.first], ghostOwnRate);
+  }
+
+  for (unsigned index{ 0U }; index < GpuGridT::n; ++index)
+  {
+    if (!isGhost[index])
+    {
+      EXPECT_EQ(rateValues[index], sentinel);
+    }
+  }
+}
+
+} // namespace kae_tests
+
+#endif
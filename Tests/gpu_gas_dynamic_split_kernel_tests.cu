@@ -0,0 +1,444 @@
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/cell_class.h>
+#include <SrmSolver/flux_sweep.h>
+#include <SrmSolver/geometry_planes.h>
+#include <SrmSolver/gpu_gas_dynamic_kernel.h>
+#include <SrmSolver/gpu_gas_dynamic_split_kernel.h>
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/gpu_invalid_tile_tracker.h>
+#include <SrmSolver/gpu_matrix.h>
+
+#include "aliases.h"
+#include "shapes.h"
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+template <class GpuGridT>
+class AxisymmetricCircleShape : public CircleShape<GpuGridT>
+{
+public:
+
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE static ElemType getRadius(unsigned, unsigned j) { return j * GpuGridT::hy + 1; }
+};
+
+template <class GpuGridT, class GasStateT>
+struct SmoothGasState
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE GasStateT operator()(unsigned i, unsigned j) const
+  {
+    const ElemType x = i * GpuGridT::hx;
+    const ElemType y = j * GpuGridT::hy;
+    return GasStateT{ static_cast<ElemType>(1.0) + static_cast<ElemType>(0.1) * std::sin(x + y),
+                      static_cast<ElemType>(0.2) * std::cos(x),
+                      static_cast<ElemType>(-0.1) * std::sin(y),
+                      static_cast<ElemType>(1.0) + static_cast<ElemType>(0.2) * std::cos(x - y) };
+  }
+};
+
+template <class GpuGridT, class GasStateT>
+struct GasStateWithNegativePressure
+{
+  constexpr static unsigned iBad{ GpuGridT::nx / 2U };
+  constexpr static unsigned jBad{ GpuGridT::ny / 2U };
+
+  HOST_DEVICE GasStateT operator()(unsigned i, unsigned j) const
+  {
+    auto state = SmoothGasState<GpuGridT, GasStateT>{}(i, j);
+    if ((i == iBad) && (j == jBad))
+    {
+      state.p = -1;
+    }
+
+    return state;
+  }
+};
+
+template <class GpuGridT>
+struct ReinitializedCircle
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE ElemType operator()(unsigned i, unsigned j) const
+  {
+    return CircleShape<GpuGridT>::reinitializedValue(i, j);
+  }
+};
+
+template <class GpuGridT>
+struct ReinitializedCircleClasses
+{
+  HOST_DEVICE std::uint8_t operator()(unsigned i, unsigned j) const
+  {
+    return kae::CellClass::get<GpuGridT>(ReinitializedCircle<GpuGridT>{}(i, j));
+  }
+};
+
+template <class T>
+class gpu_gas_dynamic_split_kernel : public ::testing::Test
+{
+public:
+
+  constexpr static unsigned nx{ std::tuple_element_t<1U, T>::value };
+  constexpr static unsigned ny{ std::tuple_element_t<1U, T>::value };
+  constexpr static unsigned smExtension{ 3U };
+  using ElemType    = std::tuple_element_t<0U, T>;
+  using LxToType    = std::ratio<4, 1>;
+  using LyToType    = std::ratio<4, 1>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, smExtension, ElemType>;
+  using ShapeType   = AxisymmetricCircleShape<GpuGridType>;
+  using GasStateT   = GasStateType<std::ratio<12, 10>, std::ratio<6, 1>, ElemType>;
+};
+
+using TypeParams = ::testing::Types<
+  std::tuple<float,  std::integral_constant<unsigned, 100U> >,
+  std::tuple<float,  std::integral_constant<unsigned, 203U> >,
+  std::tuple<double, std::integral_constant<unsigned, 100U> >,
+  std::tuple<double, std::integral_constant<unsigned, 203U> >
+>;
+TYPED_TEST_SUITE(gpu_gas_dynamic_split_kernel, TypeParams);
+
+TYPED_TEST(gpu_gas_dynamic_split_kernel, gpu_gas_dynamic_split_kernel_matches_fused_kernel)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using ShapeT    = typename tf::ShapeType;
+  using GasStateT = typename tf::GasStateT;
+
+  const thrust::device_vector<int8_t> calculateBlocks(maxSizeX * maxSizeY, 1);
+
+  thrust::device_vector<unsigned> activeTiles;
+  const auto activeTileCount = kae::detail::buildActiveTiles<GpuGridT>(calculateBlocks, activeTiles);
+
+  const kae::GpuMatrix<GpuGridT, ElemT> currPhi{ ReinitializedCircle<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ ReinitializedCircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> rReciprocals{ kae::detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> prevState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> firstState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  kae::GpuMatrix<GpuGridT, GasStateT> fusedState{ prevState };
+  kae::GpuMatrix<GpuGridT, GasStateT> splitState{ prevState };
+
+  thrust::device_vector<GasStateT> transposedState(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> xFluxes(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> yFluxes(GpuGridT::n);
+
+  const ElemT dt{ static_cast<ElemT>(0.1) * GpuGridT::hx };
+  const kae::CudaFloat2T<ElemT> lambda{ static_cast<ElemT>(2.0), static_cast<ElemT>(2.0) };
+  const ElemT prevWeight{ static_cast<ElemT>(0.25) };
+
+  kae::detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(prevState), getDevicePtr(firstState), getDevicePtr(fusedState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), activeTiles.data(), activeTileCount, dt, lambda, prevWeight);
+  kae::detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(prevState), getDevicePtr(firstState), getDevicePtr(splitState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), calculateBlocks.data(),
+    transposedState.data(), xFluxes.data(), yFluxes.data(),
+    dt, lambda, prevWeight);
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<ElemT> phiValues = currPhi.values();
+  const thrust::host_vector<GasStateT> fusedValues = fusedState.values();
+  const thrust::host_vector<GasStateT> splitValues = splitState.values();
+
+  const ElemT threshold = 100 * std::numeric_limits<ElemT>::epsilon();
+  for (unsigned index{ 0U }; index < GpuGridT::n; ++index)
+  {
+    if (phiValues[index] >= 0)
+    {
+      continue;
+    }
+
+    EXPECT_NEAR(fusedValues[index].rho, splitValues[index].rho, threshold);
+    EXPECT_NEAR(fusedValues[index].ux, splitValues[index].ux, threshold);
+    EXPECT_NEAR(fusedValues[index].uy, splitValues[index].uy, threshold);
+    EXPECT_NEAR(fusedValues[index].p, splitValues[index].p, threshold);
+  }
+}
+
+TYPED_TEST(gpu_gas_dynamic_split_kernel, gpu_gas_dynamic_split_kernel_in_place_stage)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using ShapeT    = typename tf::ShapeType;
+  using GasStateT = typename tf::GasStateT;
+
+  const thrust::device_vector<int8_t> calculateBlocks(maxSizeX * maxSizeY, 1);
+
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ ReinitializedCircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> rReciprocals{ kae::detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> firstState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> prevState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  kae::GpuMatrix<GpuGridT, GasStateT> outOfPlaceState{ prevState };
+  kae::GpuMatrix<GpuGridT, GasStateT> inPlaceState{ prevState };
+
+  thrust::device_vector<GasStateT> transposedState(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> xFluxes(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> yFluxes(GpuGridT::n);
+
+  const ElemT dt{ static_cast<ElemT>(0.1) * GpuGridT::hx };
+  const kae::CudaFloat2T<ElemT> lambda{ static_cast<ElemT>(2.0), static_cast<ElemT>(2.0) };
+  const ElemT prevWeight{ static_cast<ElemT>(0.25) };
+
+  kae::detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(prevState), getDevicePtr(firstState), getDevicePtr(outOfPlaceState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), calculateBlocks.data(),
+    transposedState.data(), xFluxes.data(), yFluxes.data(),
+    dt, lambda, prevWeight);
+  kae::detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(inPlaceState), getDevicePtr(firstState), getDevicePtr(inPlaceState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), calculateBlocks.data(),
+    transposedState.data(), xFluxes.data(), yFluxes.data(),
+    dt, lambda, prevWeight);
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<GasStateT> outOfPlaceValues = outOfPlaceState.values();
+  const thrust::host_vector<GasStateT> inPlaceValues = inPlaceState.values();
+  for (unsigned index{ 0U }; index < GpuGridT::n; ++index)
+  {
+    EXPECT_EQ(outOfPlaceValues[index].rho, inPlaceValues[index].rho);
+    EXPECT_EQ(outOfPlaceValues[index].ux, inPlaceValues[index].ux);
+    EXPECT_EQ(outOfPlaceValues[index].uy, inPlaceValues[index].uy);
+    EXPECT_EQ(outOfPlaceValues[index].p, inPlaceValues[index].p);
+  }
+}
+
+TYPED_TEST(gpu_gas_dynamic_split_kernel, gpu_gas_dynamic_split_kernel_invalid_tiles)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using ShapeT    = typename tf::ShapeType;
+  using GasStateT = typename tf::GasStateT;
+  using BadStateT = GasStateWithNegativePressure<GpuGridT, GasStateT>;
+
+  const thrust::device_vector<int8_t> calculateBlocks(maxSizeX * maxSizeY, 1);
+
+  thrust::device_vector<unsigned> activeTiles;
+  const auto activeTileCount = kae::detail::buildActiveTiles<GpuGridT>(calculateBlocks, activeTiles);
+
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ ReinitializedCircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> rReciprocals{ kae::detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> smoothState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> badState{ BadStateT{} };
+  kae::GpuMatrix<GpuGridT, GasStateT> currState{ smoothState };
+
+  thrust::device_vector<GasStateT> transposedState(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> xFluxes(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> yFluxes(GpuGridT::n);
+
+  const ElemT dt{ static_cast<ElemT>(0.1) * GpuGridT::hx };
+  const kae::CudaFloat2T<ElemT> lambda{ static_cast<ElemT>(2.0), static_cast<ElemT>(2.0) };
+  const ElemT prevWeight{ static_cast<ElemT>(1.0) };
+
+  const unsigned badTile = (BadStateT::jBad / GpuGridT::blockSize.y) * GpuGridT::gridSize.x +
+                            BadStateT::iBad / GpuGridT::blockSize.x;
+  for (const auto fluxSweep : { kae::EFluxSweep::eFused, kae::EFluxSweep::eDimensionallySplit })
+  {
+    kae::GpuInvalidTileTracker<GpuGridT> tracker;
+    for (const auto * pPrevState : { &smoothState, &badState })
+    {
+      if (fluxSweep == kae::EFluxSweep::eFused)
+      {
+        kae::detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, GasStateT>(
+          getDevicePtr(*pPrevState), getDevicePtr(smoothState), getDevicePtr(currState), getDevicePtr(cellClasses),
+          getDevicePtr(rReciprocals), activeTiles.data(), activeTileCount, dt, lambda, prevWeight,
+          tracker.flags(pPrevState == &smoothState ? 0U : 1U));
+      }
+      else
+      {
+        kae::detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+          getDevicePtr(*pPrevState), getDevicePtr(smoothState), getDevicePtr(currState), getDevicePtr(cellClasses),
+          getDevicePtr(rReciprocals), calculateBlocks.data(),
+          transposedState.data(), xFluxes.data(), yFluxes.data(),
+          dt, lambda, prevWeight,
+          tracker.flags(pPrevState == &smoothState ? 0U : 1U));
+      }
+      cudaDeviceSynchronize();
+
+      EXPECT_EQ(tracker.isSet(), pPrevState == &badState);
+    }
+
+    std::uint64_t subStepIndex{ 0U };
+    const auto tiles = tracker.getFirstInvalidTiles(subStepIndex);
+    EXPECT_EQ(subStepIndex, 1U);
+    EXPECT_NE(std::find(std::begin(tiles), std::end(tiles), badTile), std::end(tiles));
+    for (const auto tile : tiles)
+    {
+      EXPECT_LE(std::abs(static_cast<int>(tile % GpuGridT::gridSize.x) - static_cast<int>(badTile % GpuGridT::gridSize.x)), 1);
+      EXPECT_LE(std::abs(static_cast<int>(tile / GpuGridT::gridSize.x) - static_cast<int>(badTile / GpuGridT::gridSize.x)), 1);
+    }
+
+    tracker.clear();
+    EXPECT_FALSE(tracker.isSet());
+    EXPECT_TRUE(tracker.getFirstInvalidTiles(subStepIndex).empty());
+  }
+}
+
+TYPED_TEST(gpu_gas_dynamic_split_kernel, gpu_gas_dynamic_kernel_sparse_active_tiles)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using ShapeT    = typename tf::ShapeType;
+  using GasStateT = typename tf::GasStateT;
+
+  // Every third tile in a staggered pattern, so consecutive blocks of the sparse launch map to scattered tiles.
+  std::vector<int8_t> calculateBlockValues(maxSizeX * maxSizeY, 0);
+  std::vector<unsigned> expectedTiles;
+  for (unsigned tileY{ 0U }; tileY < GpuGridT::gridSize.y; ++tileY)
+  {
+    for (unsigned tileX{ 0U }; tileX < GpuGridT::gridSize.x; ++tileX)
+    {
+      if ((tileX + 2U * tileY) % 3U == 0U)
+      {
+        calculateBlockValues[tileY * maxSizeX + tileX] = 1;
+        expectedTiles.push_back(tileY * GpuGridT::gridSize.x + tileX);
+      }
+    }
+  }
+
+  const thrust::device_vector<int8_t> sparseBlocks(std::begin(calculateBlockValues), std::end(calculateBlockValues));
+  const thrust::device_vector<int8_t> fullBlocks(maxSizeX * maxSizeY, 1);
+
+  thrust::device_vector<unsigned> sparseTiles;
+  thrust::device_vector<unsigned> fullTiles;
+  const auto sparseTileCount = kae::detail::buildActiveTiles<GpuGridT>(sparseBlocks, sparseTiles);
+  const auto fullTileCount = kae::detail::buildActiveTiles<GpuGridT>(fullBlocks, fullTiles);
+  ASSERT_EQ(sparseTileCount, expectedTiles.size());
+  ASSERT_EQ(fullTileCount, GpuGridT::gridSize.x * GpuGridT::gridSize.y);
+
+  const thrust::host_vector<unsigned> hostSparseTiles = sparseTiles;
+  EXPECT_TRUE(std::equal(std::begin(expectedTiles), std::end(expectedTiles), std::begin(hostSparseTiles)));
+
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ ReinitializedCircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> rReciprocals{ kae::detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> prevState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  const GasStateT sentinel{ static_cast<ElemT>(7), static_cast<ElemT>(-3), static_cast<ElemT>(5), static_cast<ElemT>(11) };
+  kae::GpuMatrix<GpuGridT, GasStateT> sparseState{ sentinel };
+  kae::GpuMatrix<GpuGridT, GasStateT> fullState{ sentinel };
+
+  const ElemT dt{ static_cast<ElemT>(0.1) * GpuGridT::hx };
+  const kae::CudaFloat2T<ElemT> lambda{ static_cast<ElemT>(2.0), static_cast<ElemT>(2.0) };
+  const ElemT prevWeight{ static_cast<ElemT>(1.0) };
+
+  kae::detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(prevState), getDevicePtr(prevState), getDevicePtr(sparseState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), sparseTiles.data(), sparseTileCount, dt, lambda, prevWeight);
+  kae::detail::gasDynamicIntegrateTVDSubStepWrapper<GpuGridT, GasStateT>(
+    getDevicePtr(prevState), getDevicePtr(prevState), getDevicePtr(fullState), getDevicePtr(cellClasses),
+    getDevicePtr(rReciprocals), fullTiles.data(), fullTileCount, dt, lambda, prevWeight);
+  cudaDeviceSynchronize();
+
+  const thrust::host_vector<GasStateT> sparseValues = sparseState.values();
+  const thrust::host_vector<GasStateT> fullValues = fullState.values();
+  unsigned updatedCount{ 0U };
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+    {
+      const unsigned index = j * GpuGridT::nx + i;
+      const bool isActive = calculateBlockValues[(j / GpuGridT::blockSize.y) * maxSizeX + i / GpuGridT::blockSize.x] != 0;
+      const GasStateT & expected = isActive ? fullValues[index] : sentinel;
+      EXPECT_EQ(sparseValues[index].rho, expected.rho);
+      EXPECT_EQ(sparseValues[index].ux, expected.ux);
+      EXPECT_EQ(sparseValues[index].uy, expected.uy);
+      EXPECT_EQ(sparseValues[index].p, expected.p);
+      updatedCount += (isActive && (fullValues[index].rho != sentinel.rho)) ? 1U : 0U;
+    }
+  }
+
+  EXPECT_GT(updatedCount, 0U);
+}
+
+template <class GpuGridT, class ShapeT, class GasStateT, class ElemT = typename GpuGridT::ElemType>
+thrust::host_vector<GasStateT> runSplitSubSteps(const std::vector<int8_t> & calculateBlockValues, unsigned stepCount)
+{
+  const thrust::device_vector<int8_t> calculateBlocks(std::begin(calculateBlockValues), std::end(calculateBlockValues));
+
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ ReinitializedCircleClasses<GpuGridT>{} };
+  const kae::GpuMatrix<GpuGridT, ElemT> rReciprocals{ kae::detail::RadiusReciprocalInitializer<GpuGridT, ShapeT>{} };
+  const kae::GpuMatrix<GpuGridT, GasStateT> firstState{ SmoothGasState<GpuGridT, GasStateT>{} };
+  kae::GpuMatrix<GpuGridT, GasStateT> currState{ firstState };
+
+  thrust::device_vector<GasStateT> transposedState(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> xFluxes(GpuGridT::n);
+  thrust::device_vector<kae::CudaFloat4T<ElemT>> yFluxes(GpuGridT::n);
+
+  const ElemT dt{ static_cast<ElemT>(0.1) * GpuGridT::hx };
+  const kae::CudaFloat2T<ElemT> lambda{ static_cast<ElemT>(2.0), static_cast<ElemT>(2.0) };
+  for (unsigned step{ 0U }; step < stepCount; ++step)
+  {
+    kae::detail::gasDynamicIntegrateSplitSubStepWrapper<GpuGridT, GasStateT>(
+      getDevicePtr(currState), getDevicePtr(firstState), getDevicePtr(currState), getDevicePtr(cellClasses),
+      getDevicePtr(rReciprocals), calculateBlocks.data(),
+      transposedState.data(), xFluxes.data(), yFluxes.data(),
+      dt, lambda, static_cast<ElemT>(1.0));
+  }
+  cudaDeviceSynchronize();
+
+  return currState.values();
+}
+
+TEST(gpu_gas_dynamic_split_kernel_concurrent, gpu_gas_dynamic_split_kernel_concurrent_instances)
+{
+  using ElemT      = float;
+  using LToType    = std::ratio<4, 1>;
+  using SmallGridT = kae::GpuGrid<100U, 100U, LToType, LToType, 3U, ElemT>;
+  using LargeGridT = kae::GpuGrid<203U, 203U, LToType, LToType, 3U, ElemT>;
+  using GasStateT  = GasStateType<std::ratio<12, 10>, std::ratio<6, 1>, ElemT>;
+
+  constexpr unsigned stepCount{ 20U };
+  std::vector<int8_t> checkerboardBlocks(maxSizeX * maxSizeY, 0);
+  for (unsigned idx{ 0U }; idx < checkerboardBlocks.size(); ++idx)
+  {
+    checkerboardBlocks[idx] = static_cast<int8_t>(((idx / maxSizeX + idx % maxSizeX) % 2U) == 0U);
+  }
+  const std::vector<int8_t> fullBlocks(maxSizeX * maxSizeY, 1);
+
+  const auto runSmall = [&]()
+  {
+    return runSplitSubSteps<SmallGridT, AxisymmetricCircleShape<SmallGridT>, GasStateT>(checkerboardBlocks, stepCount);
+  };
+  const auto runLarge = [&]()
+  {
+    return runSplitSubSteps<LargeGridT, AxisymmetricCircleShape<LargeGridT>, GasStateT>(fullBlocks, stepCount);
+  };
+
+  const auto goldSmall = runSmall();
+  const auto goldLarge = runLarge();
+
+  for (unsigned repeat{ 0U }; repeat < 4U; ++repeat)
+  {
+    auto smallFuture = std::async(std::launch::async, runSmall);
+    auto largeFuture = std::async(std::launch::async, runLarge);
+    const auto smallValues = smallFuture.get();
+    const auto largeValues = largeFuture.get();
+
+    ASSERT_EQ(smallValues.size(), goldSmall.size());
+    for (unsigned index{ 0U }; index < SmallGridT::n; ++index)
+    {
+      EXPECT_EQ(smallValues[index].rho, goldSmall[index].rho);
+      EXPECT_EQ(smallValues[index].p, goldSmall[index].p);
+    }
+
+    ASSERT_EQ(largeValues.size(), goldLarge.size());
+    for (unsigned index{ 0U }; index < LargeGridT::n; ++index)
+    {
+      EXPECT_EQ(largeValues[index].rho, goldLarge[index].rho);
+      EXPECT_EQ(largeValues[index].p, goldLarge[index].p);
+    }
+  }
+}
+
+} // namespace kae_tests
+
+#endif
@@ -121,6 +121,54 @@ TYPED_TEST(gpu_matrix, gpu_matrix_values_const)
   EXPECT_EQ(matrixSize, nx * ny);
 }
 
+template <class ElemT>
+struct ValuesShape
+{
+  const std::vector<ElemT> & values() const { return m_values; }
+
+  std::vector<ElemT> m_values;
+};
+
+TYPED_TEST(gpu_matrix, gpu_matrix_values_constructor_layout)
+{
+  using ElemType = TypeParam;
+  constexpr unsigned nx{ 45U };
+  constexpr unsigned ny{ 20U };
+  constexpr unsigned smExtension{ 3U };
+  using LxToType = std::ratio<35, 10>;
+  using LyToType = std::ratio<26, 100>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, smExtension, ElemType>;
+  using LayoutType = kae::TiledLayout<GpuGridType, 16U, 8U>;
+
+  Initializer initializer;
+  ValuesShape<ElemType> shape{ std::vector<ElemType>(nx * ny) };
+  for (unsigned j = 0; j < ny; ++j)
+  {
+    for (unsigned i = 0; i < nx; ++i)
+    {
+      shape.m_values[j * nx + i] = initializer(i, j);
+    }
+  }
+
+  const kae::GpuMatrix<GpuGridType, ElemType, LayoutType> matrix{ shape };
+  const kae::GpuMatrix<GpuGridType, ElemType, LayoutType> expected{ Initializer{} };
+  const thrust::host_vector<ElemType> hostValues = matrix.values();
+  const thrust::host_vector<ElemType> expectedValues = expected.values();
+  ASSERT_EQ(hostValues.size(), LayoutType::size);
+  for (unsigned j = 0; j < ny; ++j)
+  {
+    for (unsigned i = 0; i < nx; ++i)
+    {
+      const auto index = LayoutType::getIndex(i, j);
+      EXPECT_EQ(hostValues[index], expectedValues[index]);
+    }
+  }
+
+  shape.m_values.pop_back();
+  using MatrixType = kae::GpuMatrix<GpuGridType, ElemType, LayoutType>;
+  EXPECT_THROW(MatrixType{ shape }, std::invalid_argument);
+}
+
 } // namespace kae_tests
 
 #endif
@@ -0,0 +1,54 @@
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/gpu_partition_ghost_points_kernel.h>
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+TEST(gpu_partition_ghost_points, gpu_partition_ghost_points_offsets_and_order)
+{
+  using kae::EBoundaryCondition;
+  const std::vector<EBoundaryCondition> boundaryConditions{
+    EBoundaryCondition::eMassFlowInlet, EBoundaryCondition::eWall, EBoundaryCondition::eMirror,
+    EBoundaryCondition::eWall, EBoundaryCondition::eMassFlowInlet, EBoundaryCondition::eWall };
+  const std::vector<thrust::pair<unsigned, unsigned>> closestIndicesMap{
+    { 0U, 40U }, { 1U, 30U }, { 2U, 20U }, { 3U, 10U }, { 4U, 15U }, { 5U, 35U } };
+
+  std::vector<std::uint64_t> partitionKeys;
+  for (std::size_t idx{ 0U }; idx < closestIndicesMap.size(); ++idx)
+  {
+    partitionKeys.push_back(kae::detail::getGhostPartitionKey(boundaryConditions[idx], closestIndicesMap[idx].second));
+  }
+
+  thrust::device_vector<thrust::pair<unsigned, unsigned>> deviceClosestIndicesMap(std::begin(closestIndicesMap),
+                                                                                  std::end(closestIndicesMap));
+  thrust::device_vector<std::uint64_t> devicePartitionKeys(std::begin(partitionKeys), std::end(partitionKeys));
+  const auto offsets = kae::detail::partitionGhostPoints(deviceClosestIndicesMap, devicePartitionKeys);
+
+  const kae::detail::GhostPartitionOffsets goldOffsets{ 0U, 3U, 3U, 5U, 6U };
+  EXPECT_EQ(offsets, goldOffsets);
+
+  const thrust::host_vector<thrust::pair<unsigned, unsigned>> partitionedMap = deviceClosestIndicesMap;
+  const std::vector<thrust::pair<unsigned, unsigned>> goldPartitionedMap{
+    { 3U, 10U }, { 1U, 30U }, { 5U, 35U }, { 4U, 15U }, { 0U, 40U }, { 2U, 20U } };
+  for (std::size_t idx{ 0U }; idx < goldPartitionedMap.size(); ++idx)
+  {
+    EXPECT_EQ(partitionedMap[idx].first, goldPartitionedMap[idx].first);
+    EXPECT_EQ(partitionedMap[idx].second, goldPartitionedMap[idx].second);
+  }
+
+  const thrust::host_vector<std::uint64_t> partitionedKeys = devicePartitionKeys;
+  const std::vector<EBoundaryCondition> goldBoundaryConditions{
+    EBoundaryCondition::eWall, EBoundaryCondition::eWall, EBoundaryCondition::eWall,
+    EBoundaryCondition::eMassFlowInlet, EBoundaryCondition::eMassFlowInlet, EBoundaryCondition::eMirror };
+  for (std::size_t idx{ 0U }; idx < goldBoundaryConditions.size(); ++idx)
+  {
+    EXPECT_EQ(kae::detail::getGhostPartitionBoundaryCondition(partitionedKeys[idx]), goldBoundaryConditions[idx]);
+  }
+}
+
+} // namespace kae_tests
+
+#endif
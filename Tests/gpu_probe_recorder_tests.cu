@@ -0,0 +1,171 @@
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/gpu_probe_recorder.h>
+
+#include "aliases.h"
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+template <class GpuGridT, class GasStateT>
+struct LinearGasState
+{
+  using ElemType = typename GpuGridT::ElemType;
+
+  HOST_DEVICE GasStateT operator()(unsigned i, unsigned j) const
+  {
+    const ElemType x = i * GpuGridT::hx;
+    const ElemType y = j * GpuGridT::hy;
+    return GasStateT{ 1 + x + y, 2 * x, 3 * y, x - y };
+  }
+};
+
+template <class GpuGridT>
+struct LeftHalfFluid
+{
+  HOST_DEVICE std::uint8_t operator()(unsigned i, unsigned) const
+  {
+    return (i <= GpuGridT::nx / 2U) ? kae::CellClass::fluid : std::uint8_t{ 0U };
+  }
+};
+
+template <class T>
+class gpu_probe_recorder : public ::testing::Test
+{
+public:
+
+  constexpr static unsigned nx{ 41U };
+  constexpr static unsigned ny{ 21U };
+  using ElemType    = T;
+  using LxToType    = std::ratio<4, 1>;
+  using LyToType    = std::ratio<2, 1>;
+  using GpuGridType = kae::GpuGrid<nx, ny, LxToType, LyToType, 3U, ElemType>;
+  using GasStateT   = GasStateType<std::ratio<12, 10>, std::ratio<6, 1>, ElemType>;
+
+  static std::vector<ElemType> readProbeFile(const std::wstring & path, kae::ProbeFileHeader & header)
+  {
+    std::ifstream file{ std::filesystem::path{ path }, std::ios::binary };
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    std::vector<ElemType> values;
+    ElemType value;
+    while (file.read(reinterpret_cast<char *>(&value), sizeof(value)))
+    {
+      values.push_back(value);
+    }
+
+    return values;
+  }
+};
+
+using TypeParams = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(gpu_probe_recorder, TypeParams);
+
+TYPED_TEST(gpu_probe_recorder, gpu_probe_recorder_bilinear_samples)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using GasStateT = typename tf::GasStateT;
+
+  const std::wstring path{ L"gpu_probe_recorder_bilinear_samples.bin" };
+  const kae::GpuMatrix<GpuGridT, GasStateT> state{ LinearGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ kae::CellClass::fluid };
+  {
+    kae::GpuProbeRecorder<GpuGridT, GasStateT> recorder{ path, 3U };
+    EXPECT_EQ(recorder.addProbe(static_cast<ElemT>(1.23), static_cast<ElemT>(0.77)), 0U);
+    EXPECT_EQ(recorder.addLineSampler(0, 1, 4, 1, 5U), 1U);
+    EXPECT_EQ(recorder.pointCount(), 6U);
+
+    for (unsigned stepIdx{ 0U }; stepIdx < 7U; ++stepIdx)
+    {
+      recorder.record(state, cellClasses, static_cast<ElemT>(stepIdx));
+    }
+
+    EXPECT_EQ(recorder.recordedCount(), 7U);
+    EXPECT_THROW(recorder.addProbe(0, 0), std::logic_error);
+  }
+
+  kae::ProbeFileHeader header{};
+  const auto values = tf::readProbeFile(path, header);
+  std::filesystem::remove(std::filesystem::path{ path });
+
+  EXPECT_EQ(header.magic, kae::ProbeFileHeader::magicValue);
+  EXPECT_EQ(header.pointCount, 6U);
+  EXPECT_EQ(header.elemBytes, sizeof(ElemT));
+
+  constexpr unsigned recordSize{ 1U + 4U * 6U };
+  ASSERT_EQ(values.size(), 2U * 6U + 7U * recordSize);
+
+  const ElemT threshold = std::is_same<ElemT, float>::value ? static_cast<ElemT>(1e-4) : static_cast<ElemT>(1e-10);
+  for (unsigned stepIdx{ 0U }; stepIdx < 7U; ++stepIdx)
+  {
+    const auto pRecord = values.data() + 2U * 6U + stepIdx * recordSize;
+    EXPECT_EQ(pRecord[0U], static_cast<ElemT>(stepIdx));
+    for (unsigned pointIdx{ 0U }; pointIdx < 6U; ++pointIdx)
+    {
+      const ElemT x = values[2U * pointIdx];
+      const ElemT y = values[2U * pointIdx + 1U];
+      const auto pSample = pRecord + 1U + 4U * pointIdx;
+      EXPECT_NEAR(pSample[0U], 1 + x + y, threshold);
+      EXPECT_NEAR(pSample[1U], 2 * x, threshold);
+      EXPECT_NEAR(pSample[2U], 3 * y, threshold);
+      EXPECT_NEAR(pSample[3U], x - y, threshold);
+    }
+  }
+}
+
+TYPED_TEST(gpu_probe_recorder, gpu_probe_recorder_fluid_samples)
+{
+  using tf        = TestFixture;
+  using ElemT     = typename tf::ElemType;
+  using GpuGridT  = typename tf::GpuGridType;
+  using GasStateT = typename tf::GasStateT;
+
+  const std::wstring path{ L"gpu_probe_recorder_fluid_samples.bin" };
+  const kae::GpuMatrix<GpuGridT, GasStateT> state{ LinearGasState<GpuGridT, GasStateT>{} };
+  const kae::GpuMatrix<GpuGridT, std::uint8_t> cellClasses{ LeftHalfFluid<GpuGridT>{} };
+  constexpr unsigned lastFluidI = GpuGridT::nx / 2U;
+  const ElemT lastFluidX = lastFluidI * GpuGridT::hx;
+  {
+    kae::GpuProbeRecorder<GpuGridT, GasStateT> recorder{ path, 1U };
+    recorder.addProbe(lastFluidX + static_cast<ElemT>(0.25) * GpuGridT::hx, static_cast<ElemT>(1.05));
+    recorder.addProbe(lastFluidX + 5 * GpuGridT::hx, static_cast<ElemT>(1.0));
+    recorder.addProbe(static_cast<ElemT>(0.53), static_cast<ElemT>(0.77));
+    recorder.record(state, cellClasses, 0);
+  }
+
+  kae::ProbeFileHeader header{};
+  const auto values = tf::readProbeFile(path, header);
+  std::filesystem::remove(std::filesystem::path{ path });
+  constexpr unsigned recordSize{ 1U + 4U * 3U };
+  ASSERT_EQ(values.size(), 2U * 3U + recordSize);
+  const auto pRecord = values.data() + 2U * 3U;
+
+  // The solid corners drop out, so the straddling probe is interpolated along the last fluid column only and the one
+  // inside the solid takes the closest fluid cell. Probes in the fluid stay plain bilinear.
+  const ElemT threshold = std::is_same<ElemT, float>::value ? static_cast<ElemT>(1e-4) : static_cast<ElemT>(1e-10);
+  const std::array<kae::CudaFloat2T<ElemT>, 3U> expectedPoints{
+    { { lastFluidX, static_cast<ElemT>(1.05) },
+      { lastFluidX, static_cast<ElemT>(1.0) },
+      { static_cast<ElemT>(0.53), static_cast<ElemT>(0.77) } } };
+  for (unsigned pointIdx{ 0U }; pointIdx < 3U; ++pointIdx)
+  {
+    const ElemT x = expectedPoints[pointIdx].x;
+    const ElemT y = expectedPoints[pointIdx].y;
+    const auto pSample = pRecord + 1U + 4U * pointIdx;
+    EXPECT_NEAR(pSample[0U], 1 + x + y, threshold);
+    EXPECT_NEAR(pSample[1U], 2 * x, threshold);
+    EXPECT_NEAR(pSample[2U], 3 * y, threshold);
+    EXPECT_NEAR(pSample[3U], x - y, threshold);
+  }
+}
+
+} // namespace kae_tests
+
+#endif
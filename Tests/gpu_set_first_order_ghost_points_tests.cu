@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <SrmSolver/gpu_set_first_order_ghost_points_kernel.h>
+
+#ifndef _DEBUG
+
+namespace kae_tests {
+
+__global__ void addMassFlowCountersKernel(unsigned long long * pMassFlowCounters, unsigned ghostCount)
+{
+  const unsigned i = threadIdx.x + blockDim.x * blockIdx.x;
+  if (i >= ghostCount)
+  {
+    return;
+  }
+
+  // Odd ghosts skip the counters, so warps arrive with scattered lanes and not only as a prefix.
+  if (i % 2U == 0U)
+  {
+    kae::detail::addMassFlowCounters(pMassFlowCounters, i % 7U + 1U);
+  }
+}
+
+TEST(gpu_set_first_order_ghost_points, gpu_set_first_order_ghost_points_mass_flow_counters)
+{
+  for (const unsigned ghostCount : { 1U, 31U, 64U, 1000U })
+  {
+    thrust::device_vector<unsigned long long> massFlowCounters(2U, 0ULL);
+    constexpr unsigned blockSize{ 256U };
+    addMassFlowCountersKernel<<<(ghostCount + blockSize - 1U) / blockSize, blockSize>>>(
+      massFlowCounters.data().get(), ghostCount);
+    cudaDeviceSynchronize();
+
+    unsigned long long goldSolveCount{ 0ULL };
+    unsigned long long goldIterationCount{ 0ULL };
+    for (unsigned i{ 0U }; i < ghostCount; i += 2U)
+    {
+      ++goldSolveCount;
+      goldIterationCount += i % 7U + 1U;
+    }
+
+    const thrust::host_vector<unsigned long long> counters = massFlowCounters;
+    EXPECT_EQ(counters[0U], goldSolveCount);
+    EXPECT_EQ(counters[1U], goldIterationCount);
+  }
+}
+
+} // namespace kae_tests
+
+#endif
@@ -0,0 +1,113 @@
+
+#include <filesystem>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/job_spool.h>
+#include <SrmSolver/run_description.h>
+
+namespace kae_tests {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void writeRunFile(const fs::path & spool, const std::string & name, const std::string & contents)
+{
+  std::ofstream file{ spool / "incoming" / (name + ".run") };
+  file << contents;
+}
+
+} // namespace
+
+TEST(job_spool, run_description_parse)
+{
+  std::istringstream stream{ "# nozzle less sweep point\n"
+                             "shape = nozzleLess\n"
+                             "precision = double\n"
+                             "mode = laggedDynamic\n"
+                             "iterations = 500\n"
+                             "courant = 0.6\n"
+                             "timeOrder = 3\n"
+                             "fluxSweep = split\n"
+                             "writeFields = true\n"
+                             "output = runs/point_1\n" };
+  const auto run = kae::parseRunDescription(stream);
+  EXPECT_EQ(run.shape, kae::EShapeType::eNozzleLessShape);
+  EXPECT_EQ(run.elemBytes, sizeof(double));
+  EXPECT_EQ(run.mode, kae::EIntegrationMode::eLaggedDynamic);
+  EXPECT_EQ(run.iterationCount, 500U);
+  EXPECT_EQ(run.reinitializeIterationCount, 100U);
+  EXPECT_DOUBLE_EQ(run.courant, 0.6);
+  EXPECT_EQ(run.timeOrder, kae::ETimeDiscretizationOrder::eThree);
+  EXPECT_EQ(run.fluxSweep, kae::EFluxSweep::eDimensionallySplit);
+  EXPECT_TRUE(run.writeIntegrals);
+  EXPECT_TRUE(run.writeFields);
+  EXPECT_FALSE(run.outputDirectory.empty());
+
+  std::istringstream unknownKey{ "shape = nozzleLess\nnozzle = none\n" };
+  EXPECT_THROW(kae::parseRunDescription(unknownKey), std::invalid_argument);
+
+  std::istringstream unknownShape{ "shape = cylinder\n" };
+  EXPECT_THROW(kae::parseRunDescription(unknownShape), std::invalid_argument);
+
+  std::istringstream badNumber{ "iterations = many\n" };
+  EXPECT_THROW(kae::parseRunDescription(badNumber), std::invalid_argument);
+}
+
+TEST(job_spool, run_description_hash_ignores_output)
+{
+  std::istringstream firstStream{ "iterations = 100\noutput = first\n" };
+  std::istringstream secondStream{ "iterations = 100\noutput = second\n" };
+  std::istringstream thirdStream{ "iterations = 101\noutput = first\n" };
+  const auto first  = kae::parseRunDescription(firstStream);
+  const auto second = kae::parseRunDescription(secondStream);
+  const auto third  = kae::parseRunDescription(thirdStream);
+
+  EXPECT_EQ(first.hash(), second.hash());
+  EXPECT_NE(first.hash(), third.hash());
+  EXPECT_EQ(kae::toHexString(0x1AU), "000000000000001a");
+}
+
+TEST(job_spool, job_spool_claim_lifecycle)
+{
+  const auto spool = fs::temp_directory_path() / "kae_job_spool_tests";
+  fs::remove_all(spool);
+  kae::JobSpool jobSpool{ spool.wstring() };
+
+  writeRunFile(spool, "b_second", "iterations = 2\n");
+  writeRunFile(spool, "a_first", "iterations = 1\n");
+  writeRunFile(spool, "c_broken", "iterations = -\n");
+
+  const auto first = jobSpool.claim();
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->run.iterationCount, 1U);
+  EXPECT_TRUE(fs::exists(spool / "running" / "a_first.run"));
+
+  const auto second = jobSpool.claim();
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->run.iterationCount, 2U);
+
+  EXPECT_FALSE(jobSpool.claim().has_value());
+  EXPECT_TRUE(fs::exists(spool / "failed" / "c_broken.run"));
+  EXPECT_TRUE(fs::exists(spool / "failed" / "c_broken.error"));
+
+  const auto resultDirectory = jobSpool.getResultDirectory(first->run.hash());
+  jobSpool.complete(*first, resultDirectory);
+  EXPECT_TRUE(fs::exists(spool / "done" / "a_first.run"));
+  EXPECT_TRUE(fs::exists(spool / "done" / "a_first.result"));
+
+  EXPECT_EQ(jobSpool.requeueInterrupted(), 1U);
+  EXPECT_TRUE(fs::exists(spool / "incoming" / "b_second.run"));
+
+  EXPECT_FALSE(jobSpool.stopRequested());
+  std::ofstream{ spool / "stop" };
+  EXPECT_TRUE(jobSpool.stopRequested());
+  jobSpool.clearStopRequest();
+  EXPECT_FALSE(jobSpool.stopRequested());
+
+  fs::remove_all(spool);
+}
+
+} // namespace kae_tests
@@ -0,0 +1,126 @@
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <SrmSolver/live_view_ring.h>
+
+namespace kae_tests {
+
+namespace {
+
+std::wstring getRingPath(const char * name)
+{
+  return (std::filesystem::temp_directory_path() / name).wstring();
+}
+
+std::vector<float> getFrameValues(std::uint32_t iteration, std::uint32_t valueCount)
+{
+  std::vector<float> values(valueCount);
+  for (std::uint32_t idx{ 0U }; idx < valueCount; ++idx)
+  {
+    values[idx] = static_cast<float>(iteration) + static_cast<float>(idx) / valueCount;
+  }
+
+  return values;
+}
+
+} // namespace
+
+TEST(live_view_ring, live_view_ring_wraparound)
+{
+  constexpr std::uint32_t slotCount{ 4U };
+  constexpr std::uint32_t width{ 8U };
+  constexpr std::uint32_t height{ 3U };
+  constexpr std::uint32_t frameCount{ 10U };
+  const auto path = getRingPath("kae_live_view_wraparound.bin");
+  {
+    kae::LiveViewRing ring{ path, slotCount, width * height };
+    EXPECT_EQ(ring.publishedCount(), 0U);
+
+    kae::LiveViewFrameHeader header;
+    std::vector<float> values;
+    EXPECT_FALSE(ring.tryRead(0U, header, values));
+
+    for (std::uint32_t iteration{ 0U }; iteration < frameCount; ++iteration)
+    {
+      const auto frameValues = getFrameValues(iteration, width * height);
+      ASSERT_TRUE(ring.publish(kae::ELiveViewFrameKind::eField, iteration, 0.5 * iteration, width, height,
+                               frameValues.data()));
+    }
+
+    const auto oversizedValues = getFrameValues(frameCount, 2U * width * height);
+    EXPECT_FALSE(ring.publish(kae::ELiveViewFrameKind::eField, frameCount, 0.0, 2U * width, height,
+                              oversizedValues.data()));
+    EXPECT_EQ(ring.publishedCount(), frameCount);
+
+    for (std::uint32_t frameIdx{ 0U }; frameIdx < frameCount + 1U; ++frameIdx)
+    {
+      const bool isRetained = (frameIdx + slotCount >= frameCount) && (frameIdx < frameCount);
+      ASSERT_EQ(ring.tryRead(frameIdx, header, values), isRetained);
+      if (!isRetained)
+      {
+        continue;
+      }
+
+      EXPECT_EQ(header.kind, kae::ELiveViewFrameKind::eField);
+      EXPECT_EQ(header.iteration, frameIdx);
+      EXPECT_EQ(header.t, 0.5 * frameIdx);
+      EXPECT_EQ(header.width, width);
+      EXPECT_EQ(header.height, height);
+      EXPECT_EQ(header.valueCount, width * height);
+      EXPECT_EQ(values, getFrameValues(frameIdx, width * height));
+    }
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST(live_view_ring, live_view_ring_reader_racing_writer)
+{
+  constexpr std::uint32_t slotCount{ 2U };
+  constexpr std::uint32_t valueCount{ 1U << 14U };
+  constexpr std::uint32_t frameCount{ 2000U };
+  const auto path = getRingPath("kae_live_view_race.bin");
+  {
+    kae::LiveViewRing ring{ path, slotCount, valueCount };
+
+    std::atomic<bool> isWriting{ true };
+    std::thread writer{ [&ring, &isWriting]()
+    {
+      std::vector<float> values(valueCount);
+      for (std::uint32_t iteration{ 0U }; iteration < frameCount; ++iteration)
+      {
+        std::fill(std::begin(values), std::end(values), static_cast<float>(iteration));
+        ring.publish(kae::ELiveViewFrameKind::eField, iteration, 0.0, valueCount, 1U, values.data());
+      }
+      isWriting = false;
+    } };
+
+    // Every frame that reads back successfully must be a single consistent frame, whatever the writer did meanwhile.
+    kae::LiveViewFrameHeader header;
+    std::vector<float> values;
+    unsigned readCount{ 0U };
+    while (isWriting || (readCount == 0U))
+    {
+      const auto publishedCount = ring.publishedCount();
+      if ((publishedCount == 0U) || !ring.tryRead(publishedCount - 1U, header, values))
+      {
+        continue;
+      }
+
+      ++readCount;
+      ASSERT_EQ(header.iteration, publishedCount - 1U);
+      ASSERT_EQ(values.size(), valueCount);
+      const auto expected = static_cast<float>(header.iteration);
+      ASSERT_TRUE(std::all_of(std::begin(values), std::end(values), [expected](float value) { return value == expected; }));
+    }
+
+    writer.join();
+    EXPECT_GT(readCount, 0U);
+  }
+
+  std::filesystem::remove(path);
+}
+
+} // namespace kae_tests
@@ -0,0 +1,148 @@
+
+#include <chrono>
+#include <iostream>
+#include <ratio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/host_layout_kernels.h>
+#include <SrmSolver/matrix_layout.h>
+
+namespace kae_tests {
+
+namespace {
+
+using LayoutGpuGridType = kae::GpuGrid<70U, 30U, std::ratio<35, 10>, std::ratio<15, 10>, 3U, float>;
+using FlushMountedNozzleGpuGridType = kae::GpuGrid<1001U, 501U, std::ratio<2, 1>, std::ratio<1, 1>, 3U, float>;
+
+template <class GpuGridT, class LayoutT>
+bool isBijection()
+{
+  std::vector<unsigned> hits(LayoutT::size, 0U);
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+    {
+      const auto idx = LayoutT::getIndex(i, j);
+      if ((idx >= LayoutT::size) || (hits[idx]++ != 0U))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+template <class GpuGridT>
+std::vector<float> getCirclePhi()
+{
+  std::vector<float> phi(GpuGridT::n);
+  for (unsigned j{ 0U }; j < GpuGridT::ny; ++j)
+  {
+    for (unsigned i{ 0U }; i < GpuGridT::nx; ++i)
+    {
+      const float x = i * GpuGridT::hx - GpuGridT::lx / 2;
+      const float y = j * GpuGridT::hy - GpuGridT::ly / 2;
+      phi[j * GpuGridT::nx + i] = std::hypot(x, y) - GpuGridT::ly / 4;
+    }
+  }
+
+  return phi;
+}
+
+template <class GpuGridT, class LayoutT>
+std::vector<float> getGradientNorms(const std::vector<float> & rowMajorPhi)
+{
+  const auto phi = kae::detail::toLayout<GpuGridT, LayoutT>(rowMajorPhi);
+  std::vector<float> gradientNorms(LayoutT::size, 0.0f);
+  kae::detail::calculateGradientNorms<GpuGridT, LayoutT>(phi.data(), gradientNorms.data());
+  return kae::detail::fromLayout<GpuGridT, LayoutT>(gradientNorms);
+}
+
+} // namespace
+
+TEST(matrix_layout, matrix_layout_is_bijection)
+{
+  using GridT = LayoutGpuGridType;
+  EXPECT_TRUE((isBijection<GridT, kae::RowMajorLayout<GridT>>()));
+  EXPECT_TRUE((isBijection<GridT, kae::TiledLayout<GridT>>()));
+  EXPECT_TRUE((isBijection<GridT, kae::TiledLayout<GridT, 8U, 8U>>()));
+  EXPECT_TRUE((isBijection<GridT, kae::MortonTiledLayout<GridT>>()));
+  EXPECT_TRUE((isBijection<GridT, kae::MortonTiledLayout<GridT, 8U>>()));
+}
+
+TEST(matrix_layout, matrix_layout_morton_order)
+{
+  using LayoutT = kae::MortonTiledLayout<LayoutGpuGridType, 4U>;
+  EXPECT_EQ(LayoutT::getIndex(0U, 0U), 0U);
+  EXPECT_EQ(LayoutT::getIndex(1U, 0U), 1U);
+  EXPECT_EQ(LayoutT::getIndex(0U, 1U), 2U);
+  EXPECT_EQ(LayoutT::getIndex(1U, 1U), 3U);
+  EXPECT_EQ(LayoutT::getIndex(2U, 0U), 4U);
+  EXPECT_EQ(LayoutT::getIndex(3U, 3U), 15U);
+  EXPECT_EQ(LayoutT::getIndex(4U, 0U), 16U);
+  EXPECT_EQ(LayoutT::getIndex(0U, 4U), 16U * LayoutT::tileCountX);
+}
+
+TEST(matrix_layout, matrix_layout_host_kernels_agree)
+{
+  using GridT = LayoutGpuGridType;
+  const auto phi = getCirclePhi<GridT>();
+
+  const auto goldGradientNorms = getGradientNorms<GridT, kae::RowMajorLayout<GridT>>(phi);
+  EXPECT_EQ((getGradientNorms<GridT, kae::TiledLayout<GridT>>(phi)), goldGradientNorms);
+  EXPECT_EQ((getGradientNorms<GridT, kae::MortonTiledLayout<GridT>>(phi)), goldGradientNorms);
+
+  using LayoutT = kae::MortonTiledLayout<GridT>;
+  const auto mortonPhi = kae::detail::toLayout<GridT, LayoutT>(phi);
+  std::vector<unsigned> goldClosestIndices(GridT::n, 0U);
+  std::vector<unsigned> closestIndices(LayoutT::size, 0U);
+  kae::detail::calculateClosestIndices<GridT, kae::RowMajorLayout<GridT>>(phi.data(), goldClosestIndices.data());
+  kae::detail::calculateClosestIndices<GridT, LayoutT>(mortonPhi.data(), closestIndices.data());
+  for (unsigned j{ 3U }; j < GridT::ny - 3U; ++j)
+  {
+    for (unsigned i{ 3U }; i < GridT::nx - 3U; ++i)
+    {
+      EXPECT_EQ(mortonPhi[closestIndices[LayoutT::getIndex(i, j)]], phi[goldClosestIndices[j * GridT::nx + i]]);
+    }
+  }
+}
+
+template <class LayoutT>
+void measureLayout(const char * name, const std::vector<float> & rowMajorPhi)
+{
+  using GridT = FlushMountedNozzleGpuGridType;
+  constexpr unsigned iterationCount{ 20U };
+
+  const auto phi = kae::detail::toLayout<GridT, LayoutT>(rowMajorPhi);
+  std::vector<float> gradientNorms(LayoutT::size, 0.0f);
+  std::vector<unsigned> closestIndices(LayoutT::size, 0U);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned idx{ 0U }; idx < iterationCount; ++idx)
+  {
+    kae::detail::calculateGradientNorms<GridT, LayoutT>(phi.data(), gradientNorms.data());
+    kae::detail::calculateClosestIndices<GridT, LayoutT>(phi.data(), closestIndices.data());
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << name << ": " << 1e3 * seconds / iterationCount << " ms per sweep, "
+            << 1e-6 * GridT::n * iterationCount / seconds << " Mcells/s\n";
+}
+
+TEST(matrix_layout, DISABLED_matrix_layout_benchmark)
+{
+  using GridT = FlushMountedNozzleGpuGridType;
+  const auto phi = getCirclePhi<GridT>();
+
+  measureLayout<kae::RowMajorLayout<GridT>>("row major", phi);
+  measureLayout<kae::TiledLayout<GridT>>("tiled 32x8", phi);
+  measureLayout<kae::TiledLayout<GridT, 16U, 16U>>("tiled 16x16", phi);
+  measureLayout<kae::MortonTiledLayout<GridT>>("morton 16x16", phi);
+}
+
+} // namespace kae_tests
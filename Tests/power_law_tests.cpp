@@ -0,0 +1,106 @@
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <ratio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <SrmSolver/power_law.h>
+
+namespace kae_tests {
+
+namespace {
+
+std::int64_t ulpDistance(float lhs, float rhs)
+{
+  std::int32_t lhsBits;
+  std::int32_t rhsBits;
+  std::memcpy(&lhsBits, &lhs, sizeof(float));
+  std::memcpy(&rhsBits, &rhs, sizeof(float));
+  return std::abs(static_cast<std::int64_t>(lhsBits) - static_cast<std::int64_t>(rhsBits));
+}
+
+template <class NuT>
+std::int64_t getMaxUlpDistance(bool reciprocal)
+{
+  const double nu = static_cast<double>(NuT::num) / NuT::den;
+
+  std::int64_t maxDistance{ 0 };
+  for (float p = std::ldexp(1.0f, -10); p < std::ldexp(1.0f, 10); p *= 1.0001f)
+  {
+    const float value = reciprocal ? kae::PowerLaw<NuT>::getReciprocal(p) : kae::PowerLaw<NuT>::get(p);
+    const float gold  = static_cast<float>(std::pow(static_cast<double>(p), reciprocal ? -nu : nu));
+    maxDistance = std::max(maxDistance, ulpDistance(value, gold));
+  }
+
+  return maxDistance;
+}
+
+} // namespace
+
+TEST(power_law, power_law_sqrt_specialization)
+{
+  using PowerLawT = kae::PowerLaw<std::ratio<5, 10>>;
+
+  EXPECT_EQ(PowerLawT::get(4.0f), 2.0f);
+  EXPECT_EQ(PowerLawT::get(2.25), 1.5);
+  EXPECT_EQ(PowerLawT::getReciprocal(4.0f), 0.5f);
+  EXPECT_EQ((getMaxUlpDistance<std::ratio<1, 2>>(false)), 0);
+}
+
+TEST(power_law, power_law_float_ulp_bound)
+{
+  using NuType1 = std::ratio<41, 100>;
+  using NuType2 = std::ratio<1052, 10000>;
+  constexpr std::int64_t ulpBound{ 8 };
+
+  EXPECT_LE(getMaxUlpDistance<NuType1>(false), ulpBound);
+  EXPECT_LE(getMaxUlpDistance<NuType1>(true), ulpBound);
+  EXPECT_LE(getMaxUlpDistance<NuType2>(false), ulpBound);
+  EXPECT_LE(getMaxUlpDistance<NuType2>(true), ulpBound);
+}
+
+TEST(power_law, power_law_double)
+{
+  using PowerLawT = kae::PowerLaw<std::ratio<41, 100>>;
+
+  for (double p = 1e-3; p < 1e3; p *= 1.01)
+  {
+    EXPECT_NEAR(PowerLawT::get(p), std::pow(p, 0.41), 1e-14 * std::pow(p, 0.41));
+    EXPECT_NEAR(PowerLawT::getReciprocal(p), std::pow(p, -0.41), 1e-14 * std::pow(p, -0.41));
+  }
+}
+
+TEST(power_law, DISABLED_power_law_benchmark)
+{
+  using PowerLawT = kae::PowerLaw<std::ratio<41, 100>>;
+  constexpr float nu{ 0.41f };
+
+  std::vector<float> pressures(1U << 22U);
+  for (std::size_t i{ 0U }; i < pressures.size(); ++i)
+  {
+    pressures[i] = 0.5f + static_cast<float>(i) / pressures.size();
+  }
+
+  const auto measure = [&pressures](auto && function)
+  {
+    std::vector<float> values(pressures.size());
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i{ 0U }; i < pressures.size(); ++i)
+    {
+      values[i] = function(pressures[i]);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << std::chrono::duration<double, std::milli>(end - start).count() << " ms, checksum "
+              << values[values.size() / 2U] << '\n';
+  };
+
+  std::cout << "std::pow: ";
+  measure([nu](float p) { return std::pow(p, nu); });
+  std::cout << "PowerLaw: ";
+  measure([](float p) { return PowerLawT::get(p); });
+}
+
+} // namespace kae_tests
@@ -0,0 +1,122 @@
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <SrmSolver/gpu_grid.h>
+#include <SrmSolver/sdf_cache.h>
+
+namespace kae_tests {
+
+namespace {
+
+template <unsigned iterationCount>
+struct CachedShape {};
+
+using CacheGridType = kae::GpuGrid<40U, 20U, std::ratio<2, 1>, std::ratio<1, 1>, 3U, float>;
+
+std::vector<float> getCachedValues()
+{
+  std::vector<float> values(CacheGridType::n);
+  for (unsigned idx{ 0U }; idx < CacheGridType::n; ++idx)
+  {
+    values[idx] = static_cast<float>(idx) * 0.25f - 10.0f;
+  }
+
+  return values;
+}
+
+template <class GpuGridT, class ShapeT>
+kae::SdfCacheKey getKey(const std::vector<float> & inputs, unsigned iterationCount, unsigned timeOrder)
+{
+  return kae::getSdfCacheKey<GpuGridT, ShapeT>(inputs.data(), inputs.size() * sizeof(float), iterationCount, timeOrder);
+}
+
+} // namespace
+
+TEST(sdf_cache, sdf_cache_key_depends_on_all_parameters)
+{
+  const auto inputs = getCachedValues();
+  const auto key = getKey<CacheGridType, CachedShape<1U>>(inputs, 100U, 2U);
+  EXPECT_EQ(key.nx, 40U);
+  EXPECT_EQ(key.ny, 20U);
+  EXPECT_EQ(key.elemBytes, sizeof(float));
+  EXPECT_EQ(key.hash(), (getKey<CacheGridType, CachedShape<1U>>(inputs, 100U, 2U).hash()));
+
+  EXPECT_NE(key.hash(), (getKey<CacheGridType, CachedShape<2U>>(inputs, 100U, 2U).hash()));
+  EXPECT_NE(key.hash(), (getKey<CacheGridType, CachedShape<1U>>(inputs, 50U, 2U).hash()));
+  EXPECT_NE(key.hash(), (getKey<CacheGridType, CachedShape<1U>>(inputs, 100U, 1U).hash()));
+
+  using DoubleGridType = kae::GpuGrid<40U, 20U, std::ratio<2, 1>, std::ratio<1, 1>, 3U, double>;
+  EXPECT_NE(key.hash(), (getKey<DoubleGridType, CachedShape<1U>>(inputs, 100U, 2U).hash()));
+
+  auto changedInputs = inputs;
+  changedInputs.back() += 1.0f;
+  EXPECT_NE(key.hash(), (getKey<CacheGridType, CachedShape<1U>>(changedInputs, 100U, 2U).hash()));
+}
+
+TEST(sdf_cache, sdf_cache_round_trip)
+{
+  const auto directory = (std::filesystem::temp_directory_path() / "kae_sdf_cache_tests").wstring();
+  std::filesystem::remove_all(directory);
+
+  const auto values = getCachedValues();
+  const auto key    = getKey<CacheGridType, CachedShape<3U>>(values, 100U, 2U);
+  const auto bytes  = values.size() * sizeof(float);
+  ASSERT_TRUE(kae::SdfCacheFile::store(directory, key, values.data(), bytes));
+
+  {
+    const kae::SdfCacheFile cacheFile{ directory, key, bytes };
+    ASSERT_TRUE(cacheFile.isValid());
+    EXPECT_EQ(std::memcmp(cacheFile.values(), values.data(), bytes), 0);
+
+    const kae::SdfCacheFile wrongSizeFile{ directory, key, bytes / 2U };
+    EXPECT_FALSE(wrongSizeFile.isValid());
+
+    const auto otherKey = getKey<CacheGridType, CachedShape<3U>>(values, 10U, 2U);
+    const kae::SdfCacheFile missingFile{ directory, otherKey, bytes };
+    EXPECT_FALSE(missingFile.isValid());
+
+    const kae::SdfCacheFile disabledFile{ std::wstring{}, key, bytes };
+    EXPECT_FALSE(disabledFile.isValid());
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(sdf_cache, sdf_cache_load_or_compute)
+{
+  const auto directory = (std::filesystem::temp_directory_path() / "kae_sdf_cache_load_tests").wstring();
+  std::filesystem::remove_all(directory);
+
+  const auto expected = getCachedValues();
+  const auto key      = getKey<CacheGridType, CachedShape<4U>>(expected, 100U, 2U);
+  unsigned computeCount{ 0U };
+  const auto compute = [&computeCount, &expected](std::vector<float> & values)
+  {
+    return [&computeCount, &expected, &values]()
+    {
+      ++computeCount;
+      values = expected;
+    };
+  };
+
+  std::vector<float> computed(expected.size());
+  kae::loadOrCompute(directory, key, computed.data(), computed.size(), compute(computed));
+  EXPECT_EQ(computeCount, 1U);
+  EXPECT_EQ(computed, expected);
+
+  std::vector<float> loaded(expected.size());
+  kae::loadOrCompute(directory, key, loaded.data(), loaded.size(), compute(loaded));
+  EXPECT_EQ(computeCount, 1U);
+  EXPECT_EQ(loaded, expected);
+
+  std::vector<float> uncached(expected.size());
+  kae::loadOrCompute(std::wstring{}, key, uncached.data(), uncached.size(), compute(uncached));
+  EXPECT_EQ(computeCount, 2U);
+  EXPECT_EQ(uncached, expected);
+
+  std::filesystem::remove_all(directory);
+}
+
+} // namespace kae_tests